@@ -4,9 +4,10 @@
 engines/riscv.py — Stage 3: Z-machine interpreter running on QB2 RISC-V cores.
 
 Wraps ttlang/zork_risc.py which dispatches kernels/zork_interpreter_l1.cpp via
-ttnn.generic_op with per-batch device sessions (10 instructions per kernel
-invocation — the only count confirmed safe on QB2 Blackhole even when PRINT fires).
-State persists across batches via host-side bytes serialised between device sessions.
+ttnn.generic_op (10 instructions per kernel invocation — the only count confirmed
+safe on QB2 Blackhole even when PRINT fires). Turns go through a
+ttlang/zork_speculate.py SpeculativeSession, which keeps the state bytes between
+turns and pre-runs likely next commands while the player reads.
 
 Stage overview (from docs/implementation-plan.md):
     Stage 1 — SimEngine:    Pure Python Z-machine, everything on host CPU.
@@ -23,16 +24,15 @@ Batched execution model:
     (STEP_BATCHES=6 × 10 = 60).
 
     Additionally the third ttnn.generic_op() call within a single open_device()
-    session always hangs (confirmed by diag_batch3.py). run_zork() works around
-    this by opening and closing the ttnn device for EACH batch, serialising
-    ZMachineState to host-side bytes between sessions.
+    session always hangs (confirmed by diag_batch3.py). zork_risc.run_sessions()
+    works around this by reopening the device before its third launch
+    (DeviceSession), with ZMachineState read back to host bytes in between.
 
-    run_zork() (in ttlang/zork_risc.py) handles the batch loop transparently:
-        1. For each batch: open QB2 device via ttnn.open_device(device_id=0)
-        2. Allocates DRAM tensors: game, output, input, state (restored or fresh)
-        3. Runs the RISC-V kernel once per device session
-        4. Downloads state to host bytes, closes device
-        5. Repeats N times, accumulating per-batch output text
+    Each turn is one run_sessions() call of STEP_BATCHES (STARTUP_BATCHES for
+    the opening) from the state the last turn left. Between turns the
+    SpeculativeSession runs predicted commands one launch at a time in idle
+    session slots; a real command stops it after the launch in flight and is
+    served from its cache when it was predicted.
 
 TT-Lang pyenv requirement:
     The ttnn package is only available after running:
@@ -53,11 +53,14 @@ from engines.base import BaseEngine
 # than crashing at module import time.
 # ---------------------------------------------------------------------------
 try:
-    from ttlang.zork_risc import run_zork  # type: ignore[import]
+    import ttlang.zork_risc  # type: ignore[import]  # noqa: F401
     _RISCV_AVAILABLE = True
 except ImportError:
     _RISCV_AVAILABLE = False
 
+from ttlang.zork_speculate import SpeculativeSession
+from ttlang.zork_state import is_finished
+
 # ---------------------------------------------------------------------------
 # Batch constants
 # ---------------------------------------------------------------------------
@@ -91,12 +94,10 @@ class RiscVEngine(BaseEngine):
     and triggers Z-string decode overhead within the firmware watchdog window.
 
     State persistence between commands:
-        run_zork() allocates a fresh state DRAM tensor per call, so each call
-        to startup() or step() restarts the Z-machine from scratch. This matches
-        the current batched architecture where state is not shared across Python
-        calls. For a persistent game session, run_zork() would need to be
-        extended to accept an external state tensor — that is a future Stage 3+
-        enhancement.
+        The SpeculativeSession holds the kernel state bytes, so step() continues
+        the game startup() began. Each turn runs a fixed STEP_BATCHES; a turn
+        longer than that finishes in the next step() before its READ takes the
+        new command (stopping at the next READ is a future enhancement).
 
     Hardware requirement:
         - Tenstorrent QB2 Blackhole hardware (accessible via /dev/tenstorrent)
@@ -127,6 +128,7 @@ class RiscVEngine(BaseEngine):
             )
         if not Path(game_path).exists():
             raise FileNotFoundError(game_path)
+        self._session = SpeculativeSession(game_path, num_batches=STEP_BATCHES)
 
     # ------------------------------------------------------------------
     # BaseEngine interface
@@ -143,12 +145,7 @@ class RiscVEngine(BaseEngine):
         Returns:
             Game text output from the opening sequence (ASCII string).
         """
-        return run_zork(
-            self.game_path,
-            command="",
-            verbose=False,
-            num_batches=STARTUP_BATCHES,
-        )
+        return self._session.start(STARTUP_BATCHES)
 
     def step(self, command: str) -> str:
         """Execute one Zork command on QB2 RISC-V and return the response.
@@ -157,11 +154,9 @@ class RiscVEngine(BaseEngine):
         for 60 total Z-machine instructions. Most single commands complete in
         30–60 instructions, so this covers the majority of Zork inputs.
 
-        Note: Each call to step() opens a fresh QB2 device connection and
-        initialises the Z-machine from scratch (run_zork allocates a new state
-        tensor per call). This means the game state does NOT persist between
-        step() calls in the current implementation. For a true interactive loop,
-        integrate an external state tensor — a future Stage 3+ enhancement.
+        The command continues from the state the previous call left. When the
+        speculation worker already ran it from that state, the cached result is
+        returned without a launch.
 
         Args:
             command: Zork input command (e.g., "open mailbox", "go north").
@@ -170,34 +165,18 @@ class RiscVEngine(BaseEngine):
         Returns:
             Game text output for this command (ASCII string).
         """
-        return run_zork(
-            self.game_path,
-            command=command,
-            verbose=False,
-            num_batches=STEP_BATCHES,
-        )
+        return self._session.step(command)
 
     @property
     def game_over(self) -> bool:
-        """Always False — RiscVEngine does not track game state between calls.
-
-        The RISC-V kernel saves ZMachineState to DRAM within a single run_zork()
-        call, but that state is not returned to the Python layer. The host loop
-        should detect game termination by watching for empty output (the kernel
-        outputs nothing once the game finishes and interpreter halts).
-        """
-        return False
+        """True once the kernel state says the game has executed QUIT."""
+        state = self._session.state
+        return state is not None and is_finished(state)
 
     @property
     def running(self) -> bool:
-        """Always True — engine is stateless between calls; no lifecycle tracking."""
-        return True
+        return not self.game_over
 
     def close(self) -> None:
-        """No-op — run_zork opens and closes the QB2 device internally per call.
-
-        The ttnn.open_device / ttnn.close_device pair lives inside run_zork()
-        (in ttlang/zork_risc.py). Each startup() / step() call is fully
-        self-contained. There are no persistent device handles to release here.
-        """
-        pass
+        """Stop speculating. run_sessions() opens and closes the device itself."""
+        self._session.cancel()
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Host stand-in for the data-movement API, used by kernels/zork_host.cpp.
+ *
+ * Only the calls zork_interpreter_l1.cpp makes are provided. A NoC address is
+ * a "DRAM" offset, resolved by the host (host_dram_read / host_dram_write in
+ * zork_host.cpp); "L1" addresses are real host addresses (zork_host.cpp maps
+ * the L1 window at its device address). Transfers are synchronous, so the
+ * barriers are no-ops.
+ */
+#pragma once
+
+#include <cstdint>
+
+void host_dram_read(uint64_t src, uint8_t* dst, uint32_t size);
+void host_dram_write(const uint8_t* src, uint64_t dst, uint32_t size);
+
+inline uint64_t get_noc_addr(uint32_t /*x*/, uint32_t /*y*/, uint32_t addr) { return addr; }
+
+inline void noc_async_read(uint64_t src, uint32_t dst, uint32_t size) {
+    host_dram_read(src, reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(dst)), size);
+}
+
+inline void noc_async_write(uint32_t src, uint64_t dst, uint32_t size) {
+    host_dram_write(reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(src)), dst, size);
+}
+
+inline void noc_async_read_barrier() {}
+inline void noc_async_write_barrier() {}
@@ -0,0 +1,497 @@
+// SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * zork_fuzz.cpp — Snapshot-reset fuzz target over the host build of the kernel.
+ *
+ * zork_fuzz_snapshot() steps one session, one instruction per launch, until its
+ * PC sits on the first READ with that READ's UNDO snapshot taken, and keeps
+ * that state. Every case then starts from
+ * the snapshot without a launch. It puts back only what the previous case
+ * changed, loads its input into L1_INPUT (in bytecode mode it also patches a few
+ * bytes of the routines the seed command runs), and runs up to `budget`
+ * instructions in the kernel's own interpret(). A case costs its instructions
+ * plus a few hundred bytes of restore, instead of a story reload and a replay
+ * of the opening.
+ *
+ * What a case can change, and how it is put back:
+ *   registers, stack, frames  load_state() of the snapshot (live entries, as a launch does)
+ *   dynamic memory            compared with the snapshot in FUZZ_PAGE pages; dirty pages copied
+ *   globals shadow            globals_load() from the restored memory
+ *   "DRAM" (UNDO ring, SAVE)  writes are logged (ZORK_HOST_ON_WRITE) and copied back
+ *   patched code              original bytes rewritten; routine header cache cleared
+ *
+ * Static memory is write-protected while cases run, so a store into it faults
+ * instead of leaking into later cases. A SIGSEGV or SIGBUS inside interpret()
+ * (that store, or a stray pointer from mutated code) jumps back out of the case
+ * and counts as a finding. After every instruction (the kernel's ZORK_ON_STEP
+ * hook) the VM is also checked: stack and frame depth, either past the top or
+ * wrapped below zero, and output size; after the case, the PC. Any of these
+ * ends the case at the instruction that caused it. Past a fault or a broken
+ * stack the process may already be corrupted, so zork_fuzz_run() stops there
+ * and ttlang/zork_fuzz.py carries on in a fresh child. The child is also a
+ * backstop: if it dies anyway, the case that was running is kept.
+ *
+ * Built by ttlang/zork_fuzz.py (through zork_native.build) with ZORK_SESSIONS=1.
+ */
+
+#include <csetjmp>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+
+// Launches while stepping to the snapshot run one instruction each
+static uint32_t fuzz_slice = 1;
+#define ZORK_SLICE fuzz_slice
+
+// "DRAM" writes since the last restore (offset, size); overflow restores it all
+struct DramWrite {
+    uint32_t offset;
+    uint32_t size;
+};
+constexpr uint32_t FUZZ_WRITE_LOG = 32;
+static DramWrite fuzz_writes[FUZZ_WRITE_LOG];
+static uint32_t fuzz_write_count;
+
+static void fuzz_note_write(uint64_t dst, uint32_t size) {
+    if (fuzz_write_count < FUZZ_WRITE_LOG) {
+        fuzz_writes[fuzz_write_count] = {static_cast<uint32_t>(dst), size};
+    }
+    fuzz_write_count++;
+}
+
+// Checked after every instruction in a case: the first one that breaks the VM
+// ends interpret() before the next can use the broken stack or frame pointer
+static uint32_t fuzz_stop;   // FuzzKind that ended the case, FUZZ_OK if none
+static uint32_t fuzz_steps;  // instructions dispatched in the case
+static void fuzz_step();
+#define ZORK_ON_STEP() fuzz_step()
+#define ZORK_HOST_ON_WRITE(dst, size) fuzz_note_write(dst, size)
+
+#include "zork_host.cpp"
+
+constexpr uint32_t FUZZ_PAGE = 256;        // dynamic memory restore granule
+constexpr uint32_t FUZZ_INPUT_MAX = 160;   // bytes of input per case
+constexpr uint32_t FUZZ_PATCHES = 4;       // code bytes patched per bytecode case
+constexpr uint32_t FUZZ_KINDS = 6;         // finding kinds, 0 = none
+constexpr uint32_t FUZZ_KEEP = 16;         // findings kept with their case
+constexpr uint32_t FUZZ_TARGET_SPAN = 64;  // bytes mutated from each target routine
+constexpr zbyte OP_READ = 0xE4;            // VAR:0x04 sread / aread
+
+enum FuzzMode : uint32_t { FUZZ_INPUT = 0, FUZZ_BYTECODE = 1 };
+enum FuzzKind : uint32_t {
+    FUZZ_OK = 0,
+    FUZZ_STACK = 1,    // sp past the 1024-entry stack, or below zero
+    FUZZ_FRAMES = 2,   // frame_sp past the 64 call frames, or below zero
+    FUZZ_PC = 3,       // PC left the story
+    FUZZ_OUTPUT = 4,   // output ran past L1_OUT
+    FUZZ_FAULT = 5,    // SIGSEGV / SIGBUS: a stray access, or a store into static memory
+};
+
+struct FuzzCase {
+    uint32_t length;                       // input bytes
+    uint32_t patches;                      // code patches in use
+    uint32_t patch_addr[FUZZ_PATCHES];
+    uint8_t patch_value[FUZZ_PATCHES];
+    char input[FUZZ_INPUT_MAX];
+};
+
+struct FuzzFinding {
+    uint32_t kind;
+    int32_t pc;                            // PC offset when the case stopped
+    FuzzCase c;
+};
+
+/** Shared with the driver, which may read it after this process has died. */
+struct FuzzReport {
+    uint64_t cases;
+    uint64_t restored;                     // dynamic memory bytes copied back
+    uint64_t findings[FUZZ_KINDS];         // by kind
+    uint32_t kept;                         // entries in found[]
+    uint32_t running;                      // 1 while current is executing
+    FuzzCase current;
+    FuzzFinding found[FUZZ_KEEP];
+};
+
+static uint8_t snap_dram[SESSION_STATE_SIZE];   // the session's state block at the READ
+static bool snap_valid;
+
+// Bytecode mode: routines the seed case calls (byte addresses)
+constexpr uint32_t FUZZ_TARGETS = 64;
+static uint32_t fuzz_targets[FUZZ_TARGETS];
+static uint32_t fuzz_target_count;
+
+static uint32_t static_lo, static_hi;           // write-protected static pages in L1
+static uint64_t rng;
+
+// A fault inside interpret() ends the case instead of the process
+static sigjmp_buf fuzz_jump;
+static volatile sig_atomic_t fuzz_guarded;
+
+static void on_fault(int sig) {
+    if (fuzz_guarded) {
+        fuzz_guarded = 0;
+        siglongjmp(fuzz_jump, sig);
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/** What the last instruction broke, or FUZZ_OK. */
+static uint32_t vm_check() {
+    // sp and frame_sp are unsigned: a pop from an empty stack wraps below zero
+    if (static_cast<int32_t>(sp) < 0 || sp > 1024) return FUZZ_STACK;
+    if (static_cast<int32_t>(frame_sp) < 0 || frame_sp > 64) return FUZZ_FRAMES;
+    if (out_pos >= SESSION_OUTPUT_SIZE) return FUZZ_OUTPUT;
+    return FUZZ_OK;
+}
+
+static void fuzz_step() {
+    if (!fuzz_guarded) return;   // stepping to the snapshot
+    fuzz_steps++;
+    fuzz_stop = vm_check();
+    if (fuzz_stop != FUZZ_OK) finished = true;
+}
+
+static inline uint64_t next_random() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+static inline uint32_t below(uint32_t n) {
+    return static_cast<uint32_t>(next_random() % n);
+}
+
+static inline char printable() {
+    return static_cast<char>(' ' + below(95));
+}
+
+static void protect_static(bool read_only) {
+    if (static_hi > static_lo) {
+        mprotect(reinterpret_cast<void*>(static_cast<uintptr_t>(HOST_L1_GAME + static_lo)),
+                 static_hi - static_lo, read_only ? PROT_READ : PROT_READ | PROT_WRITE);
+    }
+}
+
+/** Put the VM back to the snapshot, copying only what the last case changed. */
+static void fuzz_restore(FuzzReport* report) {
+    constexpr uint32_t DYN_OFFSET = ((sizeof(ZMachineState) + 31) / 32) * 32;
+    load_state(reinterpret_cast<const ZMachineState*>(snap_dram));
+
+    const zbyte* snap_dyn = snap_dram + DYN_OFFSET;
+    uint32_t dyn_size = dynamic_size();
+    for (uint32_t off = 0; off < dyn_size; off += FUZZ_PAGE) {
+        uint32_t n = dyn_size - off < FUZZ_PAGE ? dyn_size - off : FUZZ_PAGE;
+        if (memcmp(memory + off, snap_dyn + off, n) != 0) {
+            memcpy(memory + off, snap_dyn + off, n);
+            report->restored += n;
+        }
+    }
+
+    uint8_t* dram_state = host_dram + STATE_DRAM_ADDR;
+    if (fuzz_write_count > FUZZ_WRITE_LOG) {
+        memcpy(dram_state, snap_dram, SESSION_STATE_SIZE);
+    } else {
+        for (uint32_t i = 0; i < fuzz_write_count; i++) {
+            uint32_t off = fuzz_writes[i].offset - STATE_DRAM_ADDR;
+            if (fuzz_writes[i].offset >= STATE_DRAM_ADDR && off < SESSION_STATE_SIZE) {
+                uint32_t n = fuzz_writes[i].size;
+                memcpy(dram_state + off, snap_dram + off, n < SESSION_STATE_SIZE - off ? n : SESSION_STATE_SIZE - off);
+            }
+        }
+    }
+    fuzz_write_count = 0;
+
+    // Per-launch scratch, as kernel_main() resets it for a session
+    out_pos = 0;
+    opcode_track_count = 0;
+    memset(no_frame_locals, 0, sizeof(no_frame_locals));
+#ifdef ZORK_FUSE
+    fwd_live = false;
+    fused_extra = 0;
+#endif
+    globals_load();
+    set_frame_base();
+}
+
+/** Run one case from the snapshot; returns its FuzzKind. */
+static uint32_t fuzz_case(const FuzzCase& c, uint32_t budget, FuzzReport* report) {
+    fuzz_restore(report);
+    memcpy(input, c.input, c.length);
+    input[c.length] = '\0';
+
+    zbyte original[FUZZ_PATCHES];
+    if (c.patches) {
+        protect_static(false);
+        for (uint32_t i = 0; i < c.patches; i++) {
+            original[i] = memory[c.patch_addr[i]];
+            memory[c.patch_addr[i]] = c.patch_value[i];
+        }
+        for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE; i++) {
+            routine_cache[i].addr = 0;
+        }
+        protect_static(true);
+    }
+
+    // SA_NODEFER keeps the signal unblocked after the jump, so no mask is saved
+    fuzz_stop = FUZZ_OK;
+    fuzz_steps = 0;
+    fuzz_guarded = 1;
+    int sig = sigsetjmp(fuzz_jump, 0);
+    // A ring opcode ends the slice; run it as the next launch would and go on
+    while (sig == 0 && fuzz_steps < budget && !finished) {
+        interpret(budget - fuzz_steps);
+        if (ring_stage != RING_DUE || fuzz_stop != FUZZ_OK) break;
+        ring_launch();
+    }
+    fuzz_guarded = 0;
+
+    uint32_t kind = fuzz_stop;
+    if (sig != 0) {
+        kind = FUZZ_FAULT;
+    } else if (kind == FUZZ_OK && !finished && (uint32_t)(pc - memory) >= 86000) {
+        kind = FUZZ_PC;
+    }
+
+    if (c.patches) {
+        protect_static(false);
+        for (uint32_t i = c.patches; i-- > 0;) {
+            memory[c.patch_addr[i]] = original[i];
+        }
+        protect_static(true);
+    }
+    if (c.patches || kind != FUZZ_OK) {   // stale headers, or a stray write may have hit the cache
+        for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE; i++) {
+            routine_cache[i].addr = 0;
+        }
+    }
+    return kind;
+}
+
+/** The i-th line of the newline-separated seeds (at most FUZZ_INPUT_MAX bytes). */
+static uint32_t seed_line(const char* seeds, uint32_t count, uint32_t i, char* out) {
+    const char* p = seeds;
+    for (uint32_t k = i % count; k > 0; k--) {
+        p = strchr(p, '\n') + 1;
+    }
+    uint32_t n = 0;
+    while (p[n] && p[n] != '\n' && n < FUZZ_INPUT_MAX) {
+        out[n] = p[n];
+        n++;
+    }
+    return n;
+}
+
+static void mutate_input(FuzzCase& c, const char* seeds, uint32_t count) {
+    for (uint32_t ops = 1 + below(4); ops > 0; ops--) {
+        uint32_t at = c.length ? below(c.length) : 0;
+        switch (below(6)) {
+            case 0:  // flip a bit (a NUL would just end the command)
+                if (c.length) {
+                    c.input[at] ^= static_cast<char>(1 << below(8));
+                    if (!c.input[at]) c.input[at] = ' ';
+                }
+                break;
+            case 1:  // replace a byte
+                if (c.length) c.input[at] = printable();
+                break;
+            case 2:  // insert a byte or a space
+                if (c.length < FUZZ_INPUT_MAX) {
+                    memmove(c.input + at + 1, c.input + at, c.length - at);
+                    c.input[at] = below(4) ? printable() : ' ';
+                    c.length++;
+                }
+                break;
+            case 3:  // delete a byte
+                if (c.length) {
+                    memmove(c.input + at, c.input + at + 1, c.length - at - 1);
+                    c.length--;
+                }
+                break;
+            case 4: {  // splice in another seed
+                char other[FUZZ_INPUT_MAX];
+                uint32_t n = seed_line(seeds, count, below(count), other);
+                if (c.length + 1 + n <= FUZZ_INPUT_MAX) {
+                    c.input[c.length] = ' ';
+                    memcpy(c.input + c.length + 1, other, n);
+                    c.length += 1 + n;
+                }
+                break;
+            }
+            default: {  // repeat a chunk
+                uint32_t n = c.length ? 1 + below(c.length - at) : 0;
+                if (n && c.length + n <= FUZZ_INPUT_MAX) {
+                    memmove(c.input + at + n, c.input + at, c.length - at);
+                    c.length += n;
+                }
+                break;
+            }
+        }
+    }
+}
+
+static void mutate_bytecode(FuzzCase& c) {
+    uint32_t limit = rom_size < HOST_GAME_SIZE ? rom_size : HOST_GAME_SIZE;
+    c.patches = 0;
+    for (uint32_t ops = 1 + below(FUZZ_PATCHES); ops > 0; ops--) {
+        uint32_t addr = fuzz_targets[below(fuzz_target_count)] + below(FUZZ_TARGET_SPAN);
+        if (addr >= limit) continue;
+        c.patch_addr[c.patches] = addr;
+        c.patch_value[c.patches] = below(2) ? static_cast<uint8_t>(next_random())
+                                            : static_cast<uint8_t>(memory[addr] ^ (1 << below(8)));
+        c.patches++;
+    }
+}
+
+/** Bytecode targets: the routines the unmutated seed case calls. */
+static void find_targets(const FuzzCase& seed, uint32_t budget, FuzzReport* report) {
+    for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE; i++) {
+        routine_cache[i].addr = 0;
+    }
+    fuzz_case(seed, budget, report);
+    fuzz_target_count = 0;
+    for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE && fuzz_target_count < FUZZ_TARGETS; i++) {
+        if (routine_cache[i].addr) {
+            fuzz_targets[fuzz_target_count++] = routine_cache[i].addr * 2u;
+        }
+    }
+    if (fuzz_target_count == 0) {   // no calls: mutate where the case starts
+        fuzz_targets[fuzz_target_count++] = reinterpret_cast<const ZMachineState*>(snap_dram)->pc_offset;
+    }
+}
+
+static struct sigaction saved_segv, saved_bus;
+
+static void begin_cases() {
+    // Other builds share L1: drop their cached routine headers, and reload the
+    // pristine dynamic memory once (cases never change it, so it stays loaded)
+    for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE; i++) {
+        routine_cache[i].addr = 0;
+    }
+    pristine_loaded = false;
+    uint32_t static_base = static_cast<uint32_t>(rom[0x0E] << 8 | rom[0x0F]);
+    static_lo = (static_base + 4095) & ~4095u;
+    static_hi = rom_in_l1 & ~4095u;
+    protect_static(true);
+
+    struct sigaction sa = {};
+    sa.sa_handler = on_fault;
+    sa.sa_flags = SA_NODEFER;
+    sigaction(SIGSEGV, &sa, &saved_segv);
+    sigaction(SIGBUS, &sa, &saved_bus);
+}
+
+static void end_cases() {
+    sigaction(SIGSEGV, &saved_segv, nullptr);
+    sigaction(SIGBUS, &saved_bus, nullptr);
+    protect_static(false);
+    static_lo = static_hi = 0;
+}
+
+extern "C" {
+
+/**
+ * Step state (nullptr = a new game) to its first READ and snapshot it there.
+ * Returns the instructions stepped, or -1 if the game ended or no READ came
+ * within max_instructions. zork_host_load() must have been called.
+ */
+int32_t zork_fuzz_snapshot(const uint8_t* state, uint32_t max_instructions) {
+    uint8_t* dram_state = host_dram + STATE_DRAM_ADDR;
+    memset(dram_state, 0, SESSION_STATE_SIZE);
+    if (state) memcpy(dram_state, state, SESSION_STATE_SIZE);
+    memset(host_dram + INPUT_DRAM_ADDR, 0, SESSION_INPUT_SIZE);
+    const ZMachineState* zs = reinterpret_cast<const ZMachineState*>(dram_state);
+
+    snap_valid = false;
+    fuzz_slice = 0;
+    kernel_main();   // load the state into the VM (or start the game) without running it
+    fuzz_slice = 1;
+    for (uint32_t n = 0;; n++) {
+        if (zs->finished) return -1;
+        if (zs->ring_stage == RING_TAKEN && zs->pc_offset < HOST_GAME_SIZE &&
+            memory[zs->pc_offset] == OP_READ) {
+            memcpy(snap_dram, dram_state, SESSION_STATE_SIZE);
+            snap_valid = true;
+            fuzz_write_count = 0;
+            return static_cast<int32_t>(n);
+        }
+        if (n == max_instructions) return -1;
+        kernel_main();
+    }
+}
+
+/**
+ * Run `cases` mutated cases from the snapshot, adding to *report; stops early
+ * after a stack or frame overflow, or a fault. seeds is newline-separated commands: input
+ * mode mutates them, bytecode mode runs them unchanged over mutated code.
+ * Returns false without a snapshot.
+ */
+bool zork_fuzz_run(uint32_t mode, const char* seeds, uint32_t cases, uint32_t budget,
+                   uint64_t seed, FuzzReport* report) {
+    if (!snap_valid || !seeds || !*seeds) return false;
+    uint32_t count = 1;
+    for (const char* p = seeds; (p = strchr(p, '\n')) && p[1]; p++) count++;
+    rng = seed ? seed : 0x9E3779B97F4A7C15ull;
+
+    begin_cases();
+    FuzzCase& c = report->current;
+    if (mode == FUZZ_BYTECODE) {
+        memset(&c, 0, sizeof(c));
+        c.length = seed_line(seeds, count, 0, c.input);
+        find_targets(c, budget, report);
+    }
+    for (uint32_t i = 0; i < cases; i++) {
+        memset(&c, 0, sizeof(c));
+        c.length = seed_line(seeds, count, i, c.input);
+        if (mode == FUZZ_BYTECODE) {
+            mutate_bytecode(c);
+        } else {
+            mutate_input(c, seeds, count);
+        }
+        report->running = 1;
+        uint32_t kind = fuzz_case(c, budget, report);
+        report->running = 0;
+        report->cases++;
+        if (kind != FUZZ_OK) {
+            report->findings[kind]++;
+            if (report->kept < FUZZ_KEEP) {
+                report->found[report->kept++] = {kind, static_cast<int32_t>(pc - memory), c};
+            }
+            // A fault can follow stray writes that did not fault, and a broken
+            // stack or frame pointer was used by the instruction that broke it:
+            // stop, so the driver carries on in a clean process
+            if (kind == FUZZ_STACK || kind == FUZZ_FRAMES || kind == FUZZ_FAULT) break;
+        }
+    }
+    end_cases();
+    return true;
+}
+
+/**
+ * Run one case from the snapshot and copy its output (NUL-terminated) to out.
+ * Returns the case's FuzzKind, or -1 without a snapshot.
+ */
+int32_t zork_fuzz_replay(const FuzzCase* c, uint32_t budget, char* out, uint32_t out_size) {
+    if (!snap_valid || !out_size) return -1;
+    FuzzReport scratch = {};
+    begin_cases();
+    uint32_t kind = fuzz_case(*c, budget, &scratch);
+    end_cases();
+    uint32_t n = out_pos < out_size - 1 ? out_pos : out_size - 1;
+    memcpy(out, output, n);
+    out[n] = '\0';
+    return static_cast<int32_t>(kind);
+}
+
+/** Copy the snapshot's state block (SESSION_STATE_SIZE bytes); false without one. */
+bool zork_fuzz_state(uint8_t* out) {
+    if (snap_valid) memcpy(out, snap_dram, SESSION_STATE_SIZE);
+    return snap_valid;
+}
+
+uint32_t zork_fuzz_report_size() { return sizeof(FuzzReport); }
+
+}  // extern "C"
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * zork_host.cpp — zork_interpreter_l1.cpp built as a host shared library.
+ *
+ * The kernel source is included unchanged, with the host data-movement shim in
+ * kernels/host/ standing in for the NoC. Each zork_host_launch() is one kernel
+ * launch: the same DRAM -> L1 loads, ZORK_SLICE instructions per session and
+ * L1 -> DRAM stores, so state bytes, output and instruction counts match the
+ * RISC-V core's launch for launch. ttlang/zork_native.py compiles and loads it.
+ *
+ * "DRAM" is laid out like the device tensors:
+ *   0x00000  game    — 87040 B story image (GAME_SIZE in the kernel)
+ *   0x16000  input   — ZORK_SESSIONS × 1 KB input blocks
+ *   0x18000  output  — ZORK_SESSIONS × 16 KB output text
+ *   0x28000  state   — ZORK_SESSIONS × 96 KB state blocks
+ * The game window is not a buffer: reads from it are served from the caller's
+ * read-only mapping of the story file (zero past its end), so loading a story
+ * copies nothing. The input, output and state windows point at host_dram's own
+ * blocks, or, during zork_host_launch(), straight at the caller's buffers.
+ *
+ * "L1" is the kernel's own fixed addresses (0x10000–0x60000). The caller maps
+ * that window into the process before the first launch; the kernel's statics
+ * make this a one-instance-per-process library, as on the core. The caller may
+ * also map the story itself, copy-on-write, over the first pages of L1_GAME.
+ * Then the kernel's per-launch game reload skips the static memory there, which
+ * stories only read, and refreshes just the dynamic memory below it. Static
+ * pages stay shared with the page cache (and every other process running the
+ * story); only the pages holding dynamic memory are copied, on first write.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define GAME_DRAM_ADDR   0x00000
+#define INPUT_DRAM_ADDR  0x16000
+#define OUTPUT_DRAM_ADDR 0x18000
+#define STATE_DRAM_ADDR  0x28000
+
+#ifndef ZORK_SESSIONS
+#define ZORK_SESSIONS 1
+#endif
+
+static uint8_t host_dram[STATE_DRAM_ADDR + ZORK_SESSIONS * 96 * 1024];
+
+// Where the input, output and state windows live (host_dram unless a launch moves them)
+static const uint8_t* host_inputs = host_dram + INPUT_DRAM_ADDR;
+static uint8_t* host_outputs = host_dram + OUTPUT_DRAM_ADDR;
+static uint8_t* host_states = host_dram + STATE_DRAM_ADDR;
+
+static void host_windows(const uint8_t* inputs, uint8_t* states, uint8_t* outputs) {
+    host_inputs = inputs;
+    host_states = states;
+    host_outputs = outputs;
+}
+
+static uint8_t* host_window(uint64_t addr) {
+    if (addr >= STATE_DRAM_ADDR) return host_states + (addr - STATE_DRAM_ADDR);
+    if (addr >= OUTPUT_DRAM_ADDR) return host_outputs + (addr - OUTPUT_DRAM_ADDR);
+    return const_cast<uint8_t*>(host_inputs) + (addr - INPUT_DRAM_ADDR);
+}
+
+// The kernel's game image geometry (L1_GAME and GAME_SIZE in kernel_main()).
+constexpr uint32_t HOST_L1_GAME = 0x10000;
+constexpr uint32_t HOST_GAME_SIZE = 87040;
+
+static const uint8_t* rom;      // The story mapping
+static uint32_t rom_size;
+static uint32_t rom_in_l1;      // Story bytes mapped at HOST_L1_GAME (0 = none)
+
+static void rom_copy(uint32_t off, uint8_t* dst, uint32_t size) {
+    uint32_t n = off >= rom_size ? 0 : (rom_size - off < size ? rom_size - off : size);
+    memcpy(dst, rom + off, n);
+    memset(dst + n, 0, size - n);
+}
+
+void host_dram_read(uint64_t src, uint8_t* dst, uint32_t size) {
+    if (src >= GAME_DRAM_ADDR + HOST_GAME_SIZE) {
+        memcpy(dst, host_window(src), size);
+        return;
+    }
+    uint32_t off = static_cast<uint32_t>(src - GAME_DRAM_ADDR);
+    uint32_t end = off + size;
+    if (dst == reinterpret_cast<uint8_t*>(HOST_L1_GAME) + off && off < rom_in_l1) {
+        // L1 maps the story here already: refresh only the dynamic memory below
+        // the static base (header word 0x0E); stories never write above it
+        uint32_t static_base = static_cast<uint32_t>(rom[0x0E] << 8 | rom[0x0F]);
+        uint32_t shared_from = static_base < off ? off : (static_base < end ? static_base : end);
+        uint32_t shared_to = end < rom_in_l1 ? end : rom_in_l1;
+        if (shared_from < shared_to) {
+            rom_copy(off, dst, shared_from - off);
+            rom_copy(shared_to, dst + (shared_to - off), end - shared_to);
+            return;
+        }
+    }
+    rom_copy(off, dst, size);
+}
+
+void host_dram_write(const uint8_t* src, uint64_t dst, uint32_t size) {
+#ifdef ZORK_HOST_ON_WRITE
+    ZORK_HOST_ON_WRITE(dst, size);   // zork_fuzz.cpp logs what a case changes
+#endif
+    memcpy(host_window(dst), src, size);
+}
+
+#include "zork_interpreter_l1.cpp"
+
+static_assert(sizeof(Frame) == 40, "Frame must match the RISC-V layout");
+static_assert(((sizeof(ZMachineState) + 31) / 32) * 32 == 4704,
+              "ZMachineState must match the RISC-V layout");
+// ttlang/zork_state.py names these offsets; zork_image serialises up to the end
+static_assert(offsetof(ZMachineState, ring_stage) == 4692 && sizeof(ZMachineState) == 4696,
+              "ZMachineState changed: update STATE_*_OFFSET / STATE_STRUCT_SIZE in "
+              "ttlang/zork_state.py and the serialisers in ttlang/zork_image.py");
+
+extern "C" {
+
+uint32_t zork_host_sessions() { return ZORK_SESSIONS; }
+
+/**
+ * Serve the game window from story[0, size), which must outlive its launches.
+ * in_l1 is how many of its bytes the caller has mapped at L1_GAME (0 = none).
+ */
+void zork_host_load(const uint8_t* story, uint32_t size, uint32_t in_l1) {
+    rom = story;
+    rom_size = size;
+    rom_in_l1 = in_l1 < HOST_GAME_SIZE ? in_l1 : HOST_GAME_SIZE;
+}
+
+/**
+ * One launch. inputs, states and outputs are ZORK_SESSIONS consecutive blocks
+ * of SESSION_INPUT_SIZE, SESSION_STATE_SIZE and SESSION_OUTPUT_SIZE bytes;
+ * states and outputs are updated in place.
+ */
+void zork_host_launch(const uint8_t* inputs, uint8_t* states, uint8_t* outputs) {
+    memset(outputs, 0, ZORK_SESSIONS * SESSION_OUTPUT_SIZE);
+    host_windows(inputs, states, outputs);
+    kernel_main();
+    host_windows(host_dram + INPUT_DRAM_ADDR, host_dram + STATE_DRAM_ADDR, host_dram + OUTPUT_DRAM_ADDR);
+}
+
+}  // extern "C"
@@ -20,8 +20,12 @@
  *   0x26000  L1_STACK  — 2048 B  Z-machine stack  (stack[1024] zword)
  *   0x26800  L1_FRAMES — 2400 B  call frames  (frames[64])
  *   0x27200  L1_OPCODES— 64 B    opcode trace buffer
+ *   0x27400  L1_GLOBALS— 480 B   native-endian shadow of the 240 globals
+ *   0x27600  L1_ROUTINES—2176 B  routine header cache
  *   0x30000  L1_OUT    — 16384 B output text
- *   0x34000  L1_INPUT  — 1024 B  input command
+ *   0x34000  L1_INPUT  — 1024 B  input command (+ host command block in the tail)
+ *   0x38000  L1_PRISTINE — 32 KB pristine dynamic memory (UNDO/SAVE diffs, lazy)
+ *   0x40000  L1_SNAPSHOT — 8 KB  snapshot record staging (UNDO ring, SAVE slots)
  *   0x50000  L1_STATE  — state snapshot (only when STATE_DRAM_ADDR defined)
  *
  * Everything else is identical to zork_interpreter_opt.cpp.
@@ -66,7 +70,7 @@ static zword dictionary_addr;   // Address of dictionary table
 
 // Call frame for routine calls
 struct Frame {
-    zbyte* ret_pc;       // Where to return to
+    uint32_t ret_pc;     // Where to return to, as an offset into story memory
     zbyte num_locals;    // How many local variables this routine has
     zword locals[15];    // The local variable values
     zbyte store_var;     // Where to store the return value
@@ -82,6 +86,18 @@ static bool finished;
 static zbyte* first_opcodes;    // Just the raw opcodes, not counts
 static uint32_t opcode_track_count;
 
+/**
+ * Save slot directory entry — one per SAVE slot (see "SAVE / RESTORE" below).
+ * size == 0 marks an empty slot; release/checksum tie a save to its story.
+ */
+constexpr uint32_t SAVE_SLOTS = 4;
+
+struct SaveSlot {
+    uint32_t size;       // Record size in bytes (0 = empty)
+    zword release;       // Story header word 0x02 at save time
+    zword checksum;      // Story header word 0x1C at save time
+};
+
 /**
  * Z-machine state snapshot for persistence between kernel invocations
  * This allows us to run interpret() in batches of 100 instructions
@@ -95,11 +111,79 @@ struct ZMachineState {
     bool finished;               // Execution finished flag
     uint32_t out_pos;            // Output buffer position
     uint32_t instruction_count;  // Total instructions executed across all batches
+    uint32_t undo_head;          // Next UNDO ring slot to write
+    uint32_t undo_count;         // Valid snapshots in the UNDO ring
+    uint32_t save_slot;          // Slot used by the game's next SAVE/RESTORE
+    SaveSlot save_dir[SAVE_SLOTS];  // Save slot directory
+    uint32_t verify_key;         // Story (release << 16 | checksum) the fields below describe
+    uint32_t verify_result;      // VERIFY_UNKNOWN / VERIFY_GOOD / VERIFY_BAD
+    uint32_t verify_pos;         // Bytes of the story summed so far
+    uint32_t verify_sum;         // Running byte sum
+    uint32_t ring_stage;         // RingStage (see ring_op_due)
+};
+
+// UNDO ring position — persisted through ZMachineState like sp and frame_sp
+static uint32_t undo_head;
+static uint32_t undo_count;
+
+// Save slot selection and directory — persisted the same way
+static uint32_t save_slot;
+static SaveSlot save_dir[SAVE_SLOTS];
+
+// VERIFY progress and cached result — persisted the same way
+static uint32_t verify_key;
+static uint32_t verify_result;
+static uint32_t verify_pos;
+static uint32_t verify_sum;
+
+// Ring opcode the last slice stopped at — persisted the same way
+enum RingStage : uint32_t { RING_NONE = 0, RING_DUE = 1, RING_TAKEN = 2, RING_RAN = 3 };
+static uint32_t ring_stage;
+
+/**
+ * Host command block — the last 16 bytes of the 1 KB input buffer.
+ *
+ * The command string occupies the front of the buffer (READ copies at most
+ * 200 chars), so the tail is free for out-of-band requests from the host.
+ * A zero-filled block means "no command".
+ */
+constexpr uint32_t HOST_CMD_OFFSET = 1008;
+constexpr uint32_t HOST_CMD_NONE   = 0;
+constexpr uint32_t HOST_CMD_UNDO   = 1;   // arg = number of turns to roll back
+constexpr uint32_t HOST_CMD_SLOT   = 2;   // arg = save slot for SAVE/RESTORE
+
+// Session flags, sent with every batch (not part of the saved state)
+constexpr uint32_t HOST_FLAG_HEADLESS = 1;   // print events instead of text
+
+struct HostCommand {
+    uint32_t op;
+    uint32_t arg;
+    uint32_t flags;
 };
 
+/**
+ * Headless sessions (HOST_FLAG_HEADLESS) — for explorers and benchmarks that
+ * only look at the state. Print opcodes skip decode_zstring() and write one
+ * 6-byte event record instead of text: a lowercase kind, then the operand as
+ * 5 uppercase hex digits. Kinds: s = inline string (PRINT/PRINT_RET, its byte
+ * address), p = PRINT_PADDR, a = PRINT_ADDR (byte addresses), o = PRINT_OBJ
+ * (object), n = PRINT_NUM (value), c = PRINT_CHAR, r = READ (text buffer).
+ * NEW_LINE writes nothing. The game state evolves exactly as with text.
+ */
+static bool headless;
+
 // Debug counters
 static uint32_t print_obj_calls = 0;
 
+#ifdef ZORK_FUSE
+// Superinstruction state (see "Superinstructions" above interpret()).
+// A fused producer hands its result straight to the next instruction instead of
+// pushing it: load_operand() gives fwd_value to the first stack operand it sees.
+static zword fwd_value;
+static bool fwd_live;
+static uint32_t fused_extra;    // Instructions retired inside fused handlers
+#endif
+
 // Read byte and advance PC
 #define CODE_BYTE(v) v = *pc++
 
@@ -133,37 +217,110 @@ static inline void write_word(uint32_t addr, zword value) {
 }
 
 /**
- * Get character from alphabet
- * idx is the raw 5-bit character code (0-31)
- * - Codes 0-5 are special (handled elsewhere)
- * - Codes 6-31 map to alphabet positions 0-25
+ * Native-endian shadow of the 240 global variables.
+ *
+ * read_variable() / write_variable() serve globals from this array instead of
+ * the big-endian table at global_vars_addr. The table in memory is brought up
+ * to date only when something touches that memory directly (LOADW, LOADB,
+ * STOREW, STOREB on the globals range) and before dynamic memory is saved or
+ * snapshotted. Whatever rewrites dynamic memory wholesale (the per-batch state
+ * restore, UNDO, RESTORE) reloads the shadow afterwards.
+ */
+constexpr uint32_t NUM_GLOBALS = 240;
+static zword* globals;          // Points into L1_GLOBALS (0x27400), 480 bytes
+static bool globals_dirty;      // Shadow holds writes not yet in memory
+
+static void globals_load() {
+    for (uint32_t i = 0; i < NUM_GLOBALS; i++) {
+        globals[i] = read_word(global_vars_addr + i * 2);
+    }
+    globals_dirty = false;
+}
+
+static void globals_flush() {
+    if (!globals_dirty) return;
+    for (uint32_t i = 0; i < NUM_GLOBALS; i++) {
+        write_word(global_vars_addr + i * 2, globals[i]);
+    }
+    globals_dirty = false;
+}
+
+static inline bool touches_globals(uint32_t addr, uint32_t len) {
+    return addr + len > global_vars_addr && addr < global_vars_addr + NUM_GLOBALS * 2;
+}
+
+/**
+ * A direct store hit the globals table: refresh the globals it overlapped.
+ */
+static void globals_reload(uint32_t addr, uint32_t len) {
+    uint32_t first = (addr > global_vars_addr) ? (addr - global_vars_addr) / 2 : 0;
+    uint32_t last = (addr + len - 1 - global_vars_addr) / 2;
+    if (last >= NUM_GLOBALS) last = NUM_GLOBALS - 1;
+    for (uint32_t i = first; i <= last; i++) {
+        globals[i] = read_word(global_vars_addr + i * 2);
+    }
+}
+
+/**
+ * Z-character alphabet tables — A0, A1, A2 as three rows of 32, indexed
+ * [alphabet * 32 + code]. Codes 6-31 are the alphabet letters; code 0 is a
+ * space; codes 1-5 (abbreviations, shifts) never reach the table.
  *
  * Alphabet 2 positions (Z-machine spec):
  * Position 0 (code 6): space
  * Position 1 (code 7): newline
  * Position 2+ (code 8+): 0123456789.,!?_#'"/\-:()
  */
-static char get_char(int alph, int idx) {
-    if (alph == 0) {
-        if (idx == 0) return ' ';
-        if (idx >= 6 && idx <= 31) return 'a' + (idx - 6);
-    } else if (alph == 1) {
-        if (idx == 0) return ' ';
-        if (idx >= 6 && idx <= 31) return 'A' + (idx - 6);
-    } else {
-        // Alphabet 2: punctuation and special characters
-        if (idx == 0) return ' ';
-        if (idx == 6) return ' ';   // Position 0
-        if (idx == 7) return '\n';  // Position 1 - NEWLINE!
-        // Positions 2-25: 0123456789.,!?_#'"/\-:()
-        const char* punct = "0123456789.,!?_#'\"/\\-:()";
-        if (idx >= 8 && idx <= 31) return punct[idx - 8];
+struct AlphabetTable {
+    char chars[3 * 32];
+
+    constexpr AlphabetTable() : chars() {
+        const char* a2 = "0123456789.,!?_#'\"/\\-:()";
+        for (int alph = 0; alph < 3; alph++) {
+            char* row = chars + alph * 32;
+            for (int c = 0; c < 6; c++) row[c] = '?';
+            row[0] = ' ';
+            for (int c = 6; c < 32; c++) {
+                row[c] = (alph == 0) ? (char)('a' + c - 6)
+                       : (alph == 1) ? (char)('A' + c - 6)
+                       : (c == 6) ? ' ' : (c == 7) ? '\n' : a2[c - 8];
+            }
+        }
+    }
+};
+static constexpr AlphabetTable DEFAULT_ALPHABET{};
+
+// Active alphabet: DEFAULT_ALPHABET, or custom_alphabet for a V5+ story whose
+// header word 0x34 names its own (set up in kernel_main)
+static const char* alphabet = DEFAULT_ALPHABET.chars;
+static char custom_alphabet[3 * 32];
+
+/**
+ * Install the story's alphabet table (V5+ header word 0x34: 78 bytes, codes
+ * 6-31 of A0, A1, A2). A2 codes 6 and 7 keep their fixed meanings.
+ */
+static void load_alphabet() {
+    zword table = (memory[0] >= 5) ? read_word(0x34) : 0;
+    if (table == 0 || table + 78 > 86000) {
+        alphabet = DEFAULT_ALPHABET.chars;
+        return;
+    }
+    for (int i = 0; i < 3 * 32; i++) {
+        custom_alphabet[i] = DEFAULT_ALPHABET.chars[i];
     }
-    return '?';
+    for (int alph = 0; alph < 3; alph++) {
+        for (int c = (alph == 2) ? 8 : 6; c < 32; c++) {
+            custom_alphabet[alph * 32 + c] = (char)memory[table + alph * 26 + (c - 6)];
+        }
+    }
+    alphabet = custom_alphabet;
 }
 
-// Forward declaration
+// Forward declarations
 static void decode_zstring(uint32_t addr, uint32_t max_words, uint32_t depth);
+#ifdef ZORK_FUSE
+static bool fuse_stack_consumer(zword value);
+#endif
 
 /**
  * Decode abbreviation
@@ -195,6 +352,21 @@ static void decode_zstring(uint32_t addr, uint32_t max_words, uint32_t depth) {
         zword word = read_word(addr);
         addr += 2;
 
+        // Fast path: three plain A0 letters (most lowercase prose). c + 26 has
+        // bit 5 set exactly when c >= 6, so one AND tests all three codes.
+        zbyte c0 = (word >> 10) & 0x1F;
+        zbyte c1 = (word >> 5) & 0x1F;
+        zbyte c2 = word & 0x1F;
+        if (shift == 0 && abbrev == 0 && out_pos + 3 <= 15000 &&
+            ((c0 + 26) & (c1 + 26) & (c2 + 26) & 0x20)) {
+            output[out_pos] = alphabet[c0];
+            output[out_pos + 1] = alphabet[c1];
+            output[out_pos + 2] = alphabet[c2];
+            out_pos += 3;
+            if (word & 0x8000) break;
+            continue;
+        }
+
         for (int s = 10; s >= 0; s -= 5) {
             zbyte c = (word >> s) & 0x1F;
 
@@ -205,16 +377,13 @@ static void decode_zstring(uint32_t addr, uint32_t max_words, uint32_t depth) {
                 continue;
             }
 
-            if (c >= 6) {
-                if (out_pos < 15000) output[out_pos++] = get_char(shift, c);
-                shift = 0;
-            } else if (c == 0) {
-                if (out_pos < 15000) output[out_pos++] = ' ';
+            if (c >= 6 || c == 0) {
+                if (out_pos < 15000) output[out_pos++] = alphabet[shift * 32 + c];
                 shift = 0;
-            } else if (c >= 1 && c <= 3) {
+            } else if (c <= 3) {
                 abbrev = c;
-            } else if (c == 4 || c == 5) {
-                shift = (c == 4) ? 1 : 2;
+            } else {
+                shift = c - 3;  // 4 -> A1, 5 -> A2
             }
         }
 
@@ -222,6 +391,31 @@ static void decode_zstring(uint32_t addr, uint32_t max_words, uint32_t depth) {
     }
 }
 
+/**
+ * Variable addressing — every non-stack variable is one indexed access.
+ *
+ * locals_base points one entry before the current frame's locals and
+ * globals_base 0x10 entries before the globals shadow, so variable v lives at
+ * locals_base[v] (v = 0x01-0x0F) or globals_base[v] (v = 0x10-0xFF). Only
+ * var 0 (the stack) needs its own path. locals_base follows frame_sp: every
+ * call, return and state restore calls set_frame_base().
+ *
+ * Locals past the routine's num_locals are not range-checked any more: op_call
+ * zero-fills them, so they still read as 0 until written. Outside any routine,
+ * locals_base points at no_frame_locals so stray accesses stay in bounds.
+ */
+static zword no_frame_locals[15];
+static zword* locals_base;
+static zword* globals_base;
+
+static inline void set_frame_base() {
+    locals_base = ((frame_sp > 0) ? frames[frame_sp - 1].locals : no_frame_locals) - 1;
+}
+
+static inline zword* variable_slot(zbyte var) {
+    return ((var < 0x10) ? locals_base : globals_base) + var;
+}
+
 /**
  * Read a variable value (like Ruby reading a variable)
  *
@@ -237,22 +431,9 @@ static zword read_variable(zbyte var) {
             return stack[--sp];
         }
         return 0;
-    } else if (var >= 0x01 && var <= 0x0F) {
-        // Local variable - like Ruby accessing a method's local variable
-        if (frame_sp > 0) {
-            zbyte local_num = var - 1;
-            Frame& current_frame = frames[frame_sp - 1];
-            if (local_num < current_frame.num_locals) {
-                return current_frame.locals[local_num];
-            }
-        }
-        return 0;
-    } else {
-        // Global variable - like Ruby's $my_global_variable
-        // Globals are stored at global_vars_addr in memory
-        zword addr = global_vars_addr + ((var - 0x10) * 2);
-        return read_word(addr);
     }
+    // Local or global - a single indexed load
+    return *variable_slot(var);
 }
 
 /**
@@ -264,20 +445,11 @@ static void write_variable(zbyte var, zword value) {
         if (sp < 1024) {
             stack[sp++] = value;
         }
-    } else if (var >= 0x01 && var <= 0x0F) {
-        // Local variable - like Ruby: local_var = value
-        if (frame_sp > 0) {
-            zbyte local_num = var - 1;
-            Frame& current_frame = frames[frame_sp - 1];
-            if (local_num < current_frame.num_locals) {
-                current_frame.locals[local_num] = value;
-            }
-        }
-    } else {
-        // Global variable - like Ruby: $my_global = value
-        zword addr = global_vars_addr + ((var - 0x10) * 2);
-        write_word(addr, value);
+        return;
     }
+    // Local or global - a single indexed store; globals mark the shadow dirty
+    *variable_slot(var) = value;
+    globals_dirty |= (var >= 0x10);
 }
 
 /**
@@ -287,6 +459,17 @@ static char tohex(uint8_t nibble) {
     return (nibble < 10) ? ('0' + nibble) : ('A' + (nibble - 10));
 }
 
+/**
+ * Append a headless event record (see HOST_FLAG_HEADLESS)
+ */
+static void print_event(char kind, uint32_t value) {
+    if (out_pos > 15000 - 6) return;
+    output[out_pos++] = kind;
+    for (int shift = 16; shift >= 0; shift -= 4) {
+        output[out_pos++] = tohex((value >> shift) & 0xF);
+    }
+}
+
 /**
  * Load operand based on type (matches Frotz's implementation)
  * Uses bit tests for robustness (from Frotz process.c lines 197-216)
@@ -302,6 +485,15 @@ static void load_operand(int type) {
         // Variable - bit 1 set
         zbyte var;
         CODE_BYTE(var);
+#ifdef ZORK_FUSE
+        if (var == 0 && fwd_live) {
+            // Consumer half of a superinstruction: take the producer's value
+            // instead of popping what was never pushed.
+            fwd_live = false;
+            zargs[zargc++] = fwd_value;
+            return;
+        }
+#endif
         zargs[zargc] = read_variable(var);
     } else if (type & 1) {
         // Small constant - bit 0 set
@@ -322,12 +514,69 @@ static void load_operand(int type) {
  * Bits 3-2: type of arg3
  * Bits 1-0: type of arg4
  */
-static void load_all_operands(zbyte specifier) {
-    for (int i = 6; i >= 0; i -= 2) {
-        int type = (specifier >> i) & 0x03;
-        if (type == 3) break;  // 11 = no more operands
-        load_operand(type);
+/**
+ * VAR operand specifier table — for every specifier byte, the operand count
+ * (bits 0-2) and the operand bytes that follow the specifier (bits 3-6).
+ * The operand kinds are the specifier's own 2-bit fields, so 256 bytes cover
+ * everything the decoder needs. Built at compile time; lives in .rodata.
+ */
+struct SpecifierTable {
+    zbyte info[256];
+
+    constexpr SpecifierTable() : info() {
+        for (uint32_t spec = 0; spec < 256; spec++) {
+            uint32_t count = 0;
+            uint32_t len = 0;
+            for (int i = 6; i >= 0; i -= 2) {
+                uint32_t type = (spec >> i) & 0x03;
+                if (type == 3) break;  // 11 = no more operands
+                count++;
+                len += (type == 0) ? 2 : 1;
+            }
+            info[spec] = (zbyte)(count | (len << 3));
+        }
+    }
+};
+static constexpr SpecifierTable SPEC_TABLE{};
+
+/**
+ * Value of one VAR-form operand of the given type at p; advances p.
+ */
+static inline zword decode_operand(uint32_t type, const zbyte*& p) {
+    if (type == 0) {
+        zword v = (p[0] << 8) | p[1];  // Large constant
+        p += 2;
+        return v;
+    }
+    zbyte b = *p++;
+    if (type == 1) return b;           // Small constant
+#ifdef ZORK_FUSE
+    if (b == 0 && fwd_live) {
+        // Consumer half of a superinstruction (see load_operand)
+        fwd_live = false;
+        return fwd_value;
     }
+#endif
+    return read_variable(b);
+}
+
+/**
+ * Decode the operands described by one specifier byte, appending to zargs.
+ * The table gives count and length up front, so pc moves once and the
+ * operands are fetched in order with no per-field loop.
+ */
+static void load_all_operands(zbyte specifier) {
+    zbyte info = SPEC_TABLE.info[specifier];
+    uint32_t count = info & 0x07;
+    const zbyte* p = pc;
+    pc += info >> 3;
+
+    zword* args = zargs + zargc;
+    if (count > 0) args[0] = decode_operand(specifier >> 6, p);
+    if (count > 1) args[1] = decode_operand((specifier >> 4) & 0x03, p);
+    if (count > 2) args[2] = decode_operand((specifier >> 2) & 0x03, p);
+    if (count > 3) args[3] = decode_operand(specifier & 0x03, p);
+    zargc += count;
 }
 
 /**
@@ -371,8 +620,9 @@ static void do_branch(bool condition) {
             // Special: return FALSE (0) or TRUE (1)
             if (frame_sp > 0) {
                 frame_sp--;
+                set_frame_base();
                 Frame frame = frames[frame_sp];
-                pc = frame.ret_pc;
+                pc = memory + frame.ret_pc;
                 write_variable(frame.store_var, offset);
             }
             // If frame_sp <= 0, just ignore (don't set finished)
@@ -435,7 +685,12 @@ static void op_loadw() {
     zbyte store_var;
     CODE_BYTE(store_var);
     uint32_t addr = (uint32_t)zargs[0] + (uint32_t)zargs[1] * 2;
-    write_variable(store_var, (addr + 1 < 87040) ? read_word(addr) : 0);
+    if (globals_dirty && touches_globals(addr, 2)) globals_flush();
+    zword value = (addr + 1 < 87040) ? read_word(addr) : 0;
+#ifdef ZORK_FUSE
+    if (store_var == 0 && fuse_stack_consumer(value)) return;
+#endif
+    write_variable(store_var, value);
 }
 
 /**
@@ -447,7 +702,12 @@ static void op_loadb() {
     zbyte store_var;
     CODE_BYTE(store_var);
     uint32_t addr = (uint32_t)zargs[0] + (uint32_t)zargs[1];
-    write_variable(store_var, (addr < 87040) ? read_byte(addr) : 0);
+    if (globals_dirty && touches_globals(addr, 1)) globals_flush();
+    zword value = (addr < 87040) ? read_byte(addr) : 0;
+#ifdef ZORK_FUSE
+    if (store_var == 0 && fuse_stack_consumer(value)) return;
+#endif
+    write_variable(store_var, value);
 }
 
 /**
@@ -465,7 +725,11 @@ static void op_sub() {
 static void op_mul() {
     zbyte store_var;
     CODE_BYTE(store_var);
-    write_variable(store_var, (zword)((int16_t)zargs[0] * (int16_t)zargs[1]));
+    zword value = (zword)((int16_t)zargs[0] * (int16_t)zargs[1]);
+#ifdef ZORK_FUSE
+    if (store_var == 0 && fuse_stack_consumer(value)) return;
+#endif
+    write_variable(store_var, value);
 }
 
 /**
@@ -527,6 +791,10 @@ static void op_jump() {
  */
 static void op_print_paddr() {
     uint32_t addr = (uint32_t)zargs[0] * 2;
+    if (headless) {
+        print_event('p', addr);
+        return;
+    }
     if (addr < 87040 && out_pos < 14000) {
         decode_zstring(addr, 20, 0);
     }
@@ -605,7 +873,11 @@ static void op_je() {
  */
 static void op_print() {
     uint32_t addr = pc - memory;  // Current PC as address
-    decode_zstring(addr, 30, 0);
+    if (headless) {
+        print_event('s', addr);
+    } else {
+        decode_zstring(addr, 30, 0);
+    }
 
     // Skip over the string
     while ((uint32_t)(pc - memory) < 86000) {
@@ -621,11 +893,12 @@ static void op_print() {
  */
 static void op_print_ret() {
     op_print();
-    if (out_pos < 15000) output[out_pos++] = '\n';
+    if (!headless && out_pos < 15000) output[out_pos++] = '\n';
     if (frame_sp > 0) {
         frame_sp--;
+        set_frame_base();
         Frame frame = frames[frame_sp];
-        pc = frame.ret_pc;
+        pc = memory + frame.ret_pc;
         write_variable(frame.store_var, 1);
     }
 }
@@ -634,7 +907,7 @@ static void op_print_ret() {
  * NEW_LINE opcode
  */
 static void op_new_line() {
-    if (out_pos < 15000) output[out_pos++] = '\n';
+    if (!headless && out_pos < 15000) output[out_pos++] = '\n';
 }
 
 /**
@@ -643,6 +916,40 @@ static void op_new_line() {
  * In Ruby:  result = my_function(arg1, arg2)
  * In Z-machine: CALL routine_addr arg1 arg2 -> store_var
  */
+/**
+ * Routine header cache — direct-mapped on the packed routine address.
+ *
+ * A routine header is a local count and that many big-endian default words.
+ * The cache keeps both native-endian, with the defaults zero-padded to 15, so a
+ * call is one tag compare plus a block copy into the new frame. Routines live
+ * in static memory and never change, so entries are only invalidated at batch
+ * start (L1 contents are not trusted across kernel launches).
+ */
+constexpr uint32_t ROUTINE_CACHE_SIZE = 64;
+
+struct RoutineHeader {
+    zword addr;          // Packed routine address (0 = empty; CALL 0 never looks up)
+    zword num_locals;
+    zword defaults[15];  // Default local values, zero past num_locals
+};
+static RoutineHeader* routine_cache;  // Points into L1_ROUTINES (0x27600)
+
+static const RoutineHeader& routine_header(zword routine_addr) {
+    RoutineHeader& entry =
+        routine_cache[(routine_addr ^ (routine_addr >> 6)) & (ROUTINE_CACHE_SIZE - 1)];
+    if (entry.addr != routine_addr) {
+        const zbyte* p = memory + routine_addr * 2;
+        zbyte num_locals = p[0];
+        if (num_locals > 15) num_locals = 15;
+        entry.addr = routine_addr;
+        entry.num_locals = num_locals;
+        for (int i = 0; i < 15; i++) {
+            entry.defaults[i] = (i < num_locals) ? (zword)((p[1 + i * 2] << 8) | p[2 + i * 2]) : 0;
+        }
+    }
+    return entry;
+}
+
 static void op_call() {
     // zargs[0] = routine address (like the function name in Ruby)
     // zargs[1..n] = arguments (like the parameters in Ruby)
@@ -661,44 +968,32 @@ static void op_call() {
     zbyte store_var;
     CODE_BYTE(store_var);
 
-    // 2. SAVE OUR CURRENT STATE (like Ruby remembering where we are)
-    Frame new_frame;
-    new_frame.ret_pc = pc;  // "Come back to this address when done"
-    new_frame.store_var = store_var;  // "Store result in this variable"
-
-    // 3. Go to the routine and read its header
+    // 2. Look up the routine header (local count + defaults, already swapped)
     // Multiply by 2 because addresses in v3 are word-addresses
     uint32_t byte_addr = routine_addr * 2;
     if (byte_addr >= 86000) return;  // Safety check
+    const RoutineHeader& header = routine_header(routine_addr);
 
-    zbyte* routine_ptr = memory + byte_addr;
-    zbyte num_locals = *routine_ptr++;  // "This function has N local variables"
-    new_frame.num_locals = num_locals;
-
-    // 4. Initialize local variables (like Ruby creating local vars in a method)
-    // CRITICAL: ALWAYS advance routine_ptr past the default value, even when an
-    // argument overrides it. The routine header has N default words for N locals;
-    // all N words are present in the binary regardless of how many args were passed.
-    // Skipping routine_ptr+=2 for passed args would leave pc pointing mid-header.
-    for (int i = 0; i < num_locals; i++) {
-        zword default_val = (routine_ptr[0] << 8) | routine_ptr[1];
-        routine_ptr += 2;  // Always consume the default word from the header
-        if ((uint32_t)(i + 1) < zargc) {
-            // Argument was passed - it overrides the default
-            new_frame.locals[i] = zargs[i + 1];
-        } else {
-            // No argument - use the default from the routine header
-            new_frame.locals[i] = default_val;
-        }
-    }
-
-    // 5. PUSH this frame onto call stack (like Ruby adding to stack trace)
+    // 3. PUSH the new frame (like Ruby adding to stack trace): the defaults are
+    // a block copy, then the passed arguments override the first locals
     if (frame_sp < 64) {
-        frames[frame_sp++] = new_frame;
+        Frame& frame = frames[frame_sp++];
+        frame.ret_pc = (uint32_t)(pc - memory);  // "Come back to this address when done"
+        frame.store_var = store_var;      // "Store result in this variable"
+        frame.num_locals = header.num_locals;
+        for (int i = 0; i < 15; i++) {
+            frame.locals[i] = header.defaults[i];
+        }
+        uint32_t num_args = zargc - 1;
+        if (num_args > header.num_locals) num_args = header.num_locals;
+        for (uint32_t i = 0; i < num_args; i++) {
+            frame.locals[i] = zargs[i + 1];
+        }
+        set_frame_base();
     }
 
-    // 6. JUMP to the routine! (like Ruby jumping to the method definition)
-    pc = routine_ptr;
+    // 4. JUMP to the routine body, past the header's default words
+    pc = memory + byte_addr + 1 + header.num_locals * 2;
 }
 
 /**
@@ -719,10 +1014,11 @@ static void op_ret() {
 
     // 2. POP the call stack (like Ruby finishing a method)
     frame_sp--;
+    set_frame_base();
     Frame frame = frames[frame_sp];
 
     // 3. GO BACK to where we came from (like Ruby jumping back to caller)
-    pc = frame.ret_pc;
+    pc = memory + frame.ret_pc;
 
     // 4. Store the return value where requested
     write_variable(frame.store_var, return_value);
@@ -758,6 +1054,12 @@ static void op_storew() {
     // zargs[2] = value to store
 
     uint32_t addr = zargs[0] + (zargs[1] * 2);  // Word index -> byte address
+    if (touches_globals(addr, 2)) {
+        globals_flush();
+        write_word(addr, zargs[2]);
+        globals_reload(addr, 2);
+        return;
+    }
     write_word(addr, zargs[2]);
 }
 
@@ -916,8 +1218,9 @@ static void op_rtrue() {
 
     // Return value of 1 (TRUE)
     frame_sp--;
+    set_frame_base();
     Frame frame = frames[frame_sp];
-    pc = frame.ret_pc;
+    pc = memory + frame.ret_pc;
     write_variable(frame.store_var, 1);  // TRUE = 1
 }
 
@@ -935,8 +1238,9 @@ static void op_rfalse() {
 
     // Return value of 0 (FALSE)
     frame_sp--;
+    set_frame_base();
     Frame frame = frames[frame_sp];
-    pc = frame.ret_pc;
+    pc = memory + frame.ret_pc;
     write_variable(frame.store_var, 0);  // FALSE = 0
 }
 
@@ -951,6 +1255,10 @@ static void op_print_obj() {
     print_obj_calls++;  // Debug counter
 
     zword obj_num = zargs[0];
+    if (headless) {
+        print_event('o', obj_num);
+        return;
+    }
 
     // Only show first call with more detail
     if (print_obj_calls == 1 && out_pos < 14500) {
@@ -1004,6 +1312,10 @@ static void op_print_obj() {
  */
 static void op_print_addr() {
     zword addr = zargs[0];
+    if (headless) {
+        print_event('a', addr);
+        return;
+    }
     // Stricter bounds: only decode if in reasonable range
     if (addr > 0 && addr < 85000 && out_pos < 14000) {
         decode_zstring(addr, 10, 0);  // Limit to 10 words max
@@ -1017,6 +1329,10 @@ static void op_print_addr() {
  */
 static void op_print_char() {
     zbyte ch = (zbyte)zargs[0];
+    if (headless) {
+        print_event('c', ch);
+        return;
+    }
     if (out_pos < 15000) output[out_pos++] = ch;
 }
 
@@ -1027,6 +1343,10 @@ static void op_print_char() {
  * This fixes the "Release ixn" bug!
  */
 static void op_print_num() {
+    if (headless) {
+        print_event('n', zargs[0]);
+        return;
+    }
     int16_t value = (int16_t)zargs[0];
 
     if (value < 0) {
@@ -1143,7 +1463,9 @@ static void op_read() {
     }
 
     // Echo the input to output for debugging
-    if (out_pos < 14900) {
+    if (headless) {
+        print_event('r', text_buffer_addr);
+    } else if (out_pos < 14900) {
         const char* prompt = "\n> ";
         while (*prompt && out_pos < 14900) {
             output[out_pos++] = *prompt++;
@@ -1177,6 +1499,12 @@ static void op_pull() {
  */
 static void op_storeb() {
     uint32_t addr = (uint32_t)zargs[0] + (uint32_t)zargs[1];
+    if (touches_globals(addr, 1)) {
+        globals_flush();
+        if (addr < 87040) memory[addr] = (zbyte)zargs[2];
+        globals_reload(addr, 1);
+        return;
+    }
     if (addr < 87040) memory[addr] = (zbyte)zargs[2];
 }
 
@@ -1221,6 +1549,576 @@ static void op_insert_obj() {
     // Would reparent zargs[0] to zargs[1]
 }
 
+/**
+ * Size of dynamic memory — the static memory base from header word 0x0E.
+ */
+static inline uint32_t dynamic_size() {
+    return ((uint32_t)memory[0x0E] << 8) | (uint32_t)memory[0x0F];
+}
+
+#ifdef STATE_DRAM_ADDR
+/**
+ * Sessions — ZORK_SESSIONS independent games time-sliced on one core.
+ *
+ * The story is loaded into L1 once per launch and shared. Each session owns a
+ * slice of each host buffer — its state tensor (VM context, dynamic-memory
+ * overlay, UNDO ring, SAVE slots), its input and its output — and kernel_main
+ * runs them round-robin, ZORK_SLICE instructions each. Switching sessions swaps
+ * the VM context and copies the session's dynamic memory over the shared image;
+ * static and high memory are never copied. A fresh session starts from the
+ * pristine dynamic memory. ZORK_SESSIONS=1 is the single-session layout.
+ *
+ * ZORK_SESSIONS × ZORK_SLICE is the launch's instruction budget: keep it within
+ * the watchdog limit (10 confirmed on QB2).
+ */
+#ifndef ZORK_SESSIONS
+#define ZORK_SESSIONS 1
+#endif
+#ifndef ZORK_SLICE
+#define ZORK_SLICE 10
+#endif
+constexpr uint32_t SESSION_STATE_SIZE  = 96 * 1024;  // STATE_SIZE on the host
+constexpr uint32_t SESSION_INPUT_SIZE  = 1024;
+constexpr uint32_t SESSION_OUTPUT_SIZE = 16384;
+
+static uint32_t state_dram_base;  // This session's ZMachineState + dynamic memory
+static uint32_t ring_dram_base;   // This session's UNDO ring, then its SAVE slots
+
+/**
+ * UNDO ring — the last UNDO_LEVELS turns, snapshotted automatically at each READ.
+ *
+ * The ring follows the 32 KB struct + dynamic memory area in the session's
+ * state block, so it travels with the rest of the state between the per-batch
+ * device sessions. With RING_DRAM_ADDR defined, the device keeps the ring and
+ * SAVE slots in a tensor of their own, so launches that do not touch them
+ * (see ring_op_due) move only the first 32 KB:
+ *
+ *   ring_dram_base + slot * SNAPSHOT_SIZE   (slot 0..7)
+ *   ring_dram_base = STATE_DRAM_ADDR + session * SESSION_STATE_SIZE + UNDO_RING_OFFSET
+ *                  | RING_DRAM_ADDR + session * (SESSION_STATE_SIZE - UNDO_RING_OFFSET)
+ *
+ * Each slot holds one snapshot record:
+ *   SnapshotHeader | stack[sp] | frames[frame_sp] | dynamic-memory diff
+ *
+ * The diff is taken against the pristine story (re-read from GAME_DRAM_ADDR on
+ * first use in a batch) as runs of [u16 skip][u16 len][len bytes]. Zork changes
+ * a few hundred bytes of its 11 KB of dynamic memory per game, so a record is
+ * far below the 4 KB slot. A turn whose record would not fit clears the ring
+ * rather than leaving a silent gap.
+ *
+ * UNDO is requested through the host command block; the restore is one NoC
+ * read of the slot plus a patch of the pristine image.
+ */
+constexpr uint32_t UNDO_RING_OFFSET = 32 * 1024;
+constexpr uint32_t UNDO_LEVELS      = 8;
+constexpr uint32_t SNAPSHOT_SIZE    = 4096;
+constexpr uint32_t L1_PRISTINE      = 0x38000;
+constexpr uint32_t PRISTINE_MAX     = 32 * 1024;
+constexpr uint32_t L1_SNAPSHOT      = 0x40000;
+
+struct SnapshotHeader {
+    uint32_t pc_offset;  // PC of the instruction to resume at (the READ itself)
+    uint32_t sp;
+    uint32_t frame_sp;
+    uint32_t diff_size;  // Bytes of dynamic-memory diff after stack and frames
+};
+
+static bool pristine_loaded;    // L1_PRISTINE valid for this batch
+
+/**
+ * Fetch the story's original dynamic memory into L1_PRISTINE (once per batch).
+ * Returns false for stories whose dynamic memory exceeds the scratch area.
+ */
+static bool load_pristine() {
+    uint32_t dyn_size = dynamic_size();
+    if (dyn_size > PRISTINE_MAX) return false;
+    if (!pristine_loaded) {
+        noc_async_read(get_noc_addr(0, 0, GAME_DRAM_ADDR), L1_PRISTINE,
+                       ((dyn_size + 31) / 32) * 32);
+        noc_async_read_barrier();
+        pristine_loaded = true;
+    }
+    return true;
+}
+
+static inline void put_u16(zbyte* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static inline uint32_t get_u16(const zbyte* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+ * Encode dynamic memory as runs that differ from the pristine image.
+ * Returns the encoded size, or UINT32_MAX if it would exceed cap.
+ */
+static uint32_t diff_dynamic(zbyte* dst, uint32_t cap) {
+    const zbyte* base = reinterpret_cast<const zbyte*>(L1_PRISTINE);
+    uint32_t dyn_size = dynamic_size();
+    uint32_t n = 0;
+    uint32_t last = 0;
+    uint32_t i = 0;
+
+    while (i < dyn_size) {
+        // Unchanged stretches dominate: skip them a word at a time
+        if ((i & 3) == 0) {
+            while (i + 4 <= dyn_size &&
+                   *reinterpret_cast<const uint32_t*>(memory + i) ==
+                   *reinterpret_cast<const uint32_t*>(base + i)) {
+                i += 4;
+            }
+        }
+        if (i >= dyn_size) break;
+        if (memory[i] == base[i]) {
+            i++;
+            continue;
+        }
+
+        // A run ends at 4 equal bytes — the cost of a new run header
+        uint32_t start = i;
+        uint32_t same = 0;
+        while (i < dyn_size && same < 4 && i - start < 0xFFFF) {
+            same = (memory[i] == base[i]) ? same + 1 : 0;
+            i++;
+        }
+        i -= same;
+        uint32_t len = i - start;
+
+        if (n + 4 + len > cap) return UINT32_MAX;
+        put_u16(dst + n, start - last);
+        put_u16(dst + n + 2, len);
+        n += 4;
+        for (uint32_t k = 0; k < len; k++) {
+            dst[n++] = memory[start + k];
+        }
+        last = i;
+    }
+    return n;
+}
+
+/**
+ * Rebuild dynamic memory from the pristine image plus a diff_dynamic() stream.
+ */
+static void patch_dynamic(const zbyte* src, uint32_t size) {
+    const zbyte* base = reinterpret_cast<const zbyte*>(L1_PRISTINE);
+    uint32_t dyn_size = dynamic_size();
+    for (uint32_t i = 0; i < dyn_size; i++) {
+        memory[i] = base[i];
+    }
+
+    uint32_t pos = 0;
+    uint32_t n = 0;
+    while (n + 4 <= size) {
+        pos += get_u16(src + n);
+        uint32_t len = get_u16(src + n + 2);
+        n += 4;
+        for (uint32_t k = 0; k < len && pos < dyn_size; k++) {
+            memory[pos++] = src[n + k];
+        }
+        n += len;
+    }
+}
+
+/**
+ * Serialise VM state and dynamic memory into a snapshot record at dst.
+ * resume_pc is where execution continues after a restore.
+ * Returns the record size, or 0 if it does not fit in cap bytes.
+ */
+static uint32_t write_snapshot(zbyte* dst, uint32_t cap, zbyte* resume_pc) {
+    globals_flush();
+    SnapshotHeader* hdr = reinterpret_cast<SnapshotHeader*>(dst);
+    hdr->pc_offset = (uint32_t)(resume_pc - memory);
+    hdr->sp = sp;
+    hdr->frame_sp = frame_sp;
+
+    uint32_t n = sizeof(SnapshotHeader);
+    uint32_t vm_size = sp * sizeof(zword) + frame_sp * sizeof(Frame);
+    if (n + vm_size > cap) return 0;
+
+    zword* stack_dst = reinterpret_cast<zword*>(dst + n);
+    for (uint32_t i = 0; i < sp; i++) {
+        stack_dst[i] = stack[i];
+    }
+    n += sp * sizeof(zword);
+
+    // Frames already hold ret_pc as an offset, so they copy as-is.
+    // Padding is zeroed so a record does not depend on what L1 held before.
+    for (; n & 3u; n++) dst[n] = 0;
+    Frame* frame_dst = reinterpret_cast<Frame*>(dst + n);
+    for (uint32_t i = 0; i < frame_sp; i++) {
+        frame_dst[i] = frames[i];
+    }
+    n += frame_sp * sizeof(Frame);
+
+    uint32_t diff = diff_dynamic(dst + n, cap - n);
+    if (diff == UINT32_MAX) return 0;
+    hdr->diff_size = diff;
+    n += diff;
+    for (uint32_t i = n; i < ((n + 31) / 32) * 32; i++) dst[i] = 0;   // NoC write rounding
+    return n;
+}
+
+/**
+ * Restore VM state and dynamic memory from a snapshot record.
+ */
+static void read_snapshot(const zbyte* src) {
+    const SnapshotHeader* hdr = reinterpret_cast<const SnapshotHeader*>(src);
+    pc = memory + hdr->pc_offset;
+    sp = hdr->sp;
+    frame_sp = hdr->frame_sp;
+    finished = false;
+
+    uint32_t n = sizeof(SnapshotHeader);
+    const zword* stack_src = reinterpret_cast<const zword*>(src + n);
+    for (uint32_t i = 0; i < sp && i < 1024; i++) {
+        stack[i] = stack_src[i];
+    }
+    n += sp * sizeof(zword);
+
+    n = (n + 3) & ~3u;
+    const Frame* frame_src = reinterpret_cast<const Frame*>(src + n);
+    for (uint32_t i = 0; i < frame_sp && i < 64; i++) {
+        frames[i] = frame_src[i];
+    }
+    n += frame_sp * sizeof(Frame);
+
+    patch_dynamic(src + n, hdr->diff_size);
+    globals_load();
+    set_frame_base();
+}
+
+/**
+ * Push a snapshot of the current turn onto the UNDO ring.
+ * Called from ring_launch() before READ runs, with read_pc pointing at the
+ * READ opcode so a restore re-executes it.
+ */
+static void undo_snapshot(zbyte* read_pc) {
+    if (!load_pristine()) return;
+
+    zbyte* rec = reinterpret_cast<zbyte*>(L1_SNAPSHOT);
+    uint32_t size = write_snapshot(rec, SNAPSHOT_SIZE, read_pc);
+    if (size == 0) {
+        undo_count = 0;
+        return;
+    }
+
+    uint32_t slot_addr = ring_dram_base + undo_head * SNAPSHOT_SIZE;
+    noc_async_write(L1_SNAPSHOT, get_noc_addr(0, 0, slot_addr), ((size + 31) / 32) * 32);
+    noc_async_write_barrier();
+
+    undo_head = (undo_head + 1) % UNDO_LEVELS;
+    if (undo_count < UNDO_LEVELS) undo_count++;
+}
+
+/**
+ * Roll back `levels` turns. The restored snapshot and everything newer leave
+ * the ring: the READ re-executed after the restore snapshots that turn again.
+ */
+static bool undo_restore(uint32_t levels) {
+    if (levels == 0 || levels > undo_count || !load_pristine()) return false;
+
+    uint32_t slot = (undo_head + UNDO_LEVELS - levels) % UNDO_LEVELS;
+    uint32_t slot_addr = ring_dram_base + slot * SNAPSHOT_SIZE;
+    noc_async_read(get_noc_addr(0, 0, slot_addr), L1_SNAPSHOT, SNAPSHOT_SIZE);
+    noc_async_read_barrier();
+
+    read_snapshot(reinterpret_cast<const zbyte*>(L1_SNAPSHOT));
+    undo_head = slot;
+    undo_count -= levels;
+    ring_stage = RING_NONE;   // the READ snapshots its turn again
+    return true;
+}
+
+/**
+ * SAVE / RESTORE — fixed-size save slots in the state tensor after the UNDO ring:
+ *
+ *   ring_dram_base + (SAVE_SLOTS_OFFSET - UNDO_RING_OFFSET) + slot * SAVE_SLOT_SIZE   (slot 0..3)
+ *
+ * A slot holds the same snapshot record as the UNDO ring (VM state plus the
+ * dynamic-memory diff against the pristine story), with twice the room since a
+ * save may come late in a long game. The directory (size, release, checksum per
+ * slot) lives in ZMachineState, so it rides the normal per-batch state write and
+ * SAVE itself is a single NoC write; RESTORE is a single NoC read plus patch.
+ *
+ * The slot comes from save_slot (host command HOST_CMD_SLOT, default 0) — V3
+ * SAVE/RESTORE take no operands, and the usual filename prompt has no place in
+ * a kernel.
+ *
+ * V3 semantics: both are branch instructions. SAVE branches on success. A
+ * successful RESTORE resumes at the SAVE that wrote the slot and takes its
+ * branch, as if that SAVE had just succeeded; a failed RESTORE branches false.
+ */
+constexpr uint32_t SAVE_SLOTS_OFFSET = UNDO_RING_OFFSET + UNDO_LEVELS * SNAPSHOT_SIZE;
+constexpr uint32_t SAVE_SLOT_SIZE    = 8192;
+
+/**
+ * SAVE opcode (0OP 0x05) — branch if saved.
+ */
+static void op_save() {
+    bool saved = false;
+    if (save_slot < SAVE_SLOTS && load_pristine()) {
+        // pc is at SAVE's branch data: a restore resumes here
+        zbyte* rec = reinterpret_cast<zbyte*>(L1_SNAPSHOT);
+        uint32_t size = write_snapshot(rec, SAVE_SLOT_SIZE, pc);
+        if (size != 0) {
+            uint32_t slot_addr = ring_dram_base + (SAVE_SLOTS_OFFSET - UNDO_RING_OFFSET) + save_slot * SAVE_SLOT_SIZE;
+            noc_async_write(L1_SNAPSHOT, get_noc_addr(0, 0, slot_addr), ((size + 31) / 32) * 32);
+            noc_async_write_barrier();
+
+            save_dir[save_slot].size = size;
+            save_dir[save_slot].release = read_word(0x02);
+            save_dir[save_slot].checksum = read_word(0x1C);
+            saved = true;
+        }
+    }
+    do_branch(saved);
+}
+
+/**
+ * RESTORE opcode (0OP 0x06) — on success, continue at the saved SAVE's branch.
+ */
+static void op_restore() {
+    if (save_slot >= SAVE_SLOTS || save_dir[save_slot].size == 0 ||
+        save_dir[save_slot].release != read_word(0x02) ||
+        save_dir[save_slot].checksum != read_word(0x1C) || !load_pristine()) {
+        do_branch(false);
+        return;
+    }
+
+    uint32_t slot_addr = ring_dram_base + (SAVE_SLOTS_OFFSET - UNDO_RING_OFFSET) + save_slot * SAVE_SLOT_SIZE;
+    noc_async_read(get_noc_addr(0, 0, slot_addr), L1_SNAPSHOT,
+                   ((save_dir[save_slot].size + 31) / 32) * 32);
+    noc_async_read_barrier();
+
+    // Flags 2 (transcript/fixed-pitch) belongs to the interpreter session, not the save
+    zword flags2 = read_word(0x10);
+    read_snapshot(reinterpret_cast<const zbyte*>(L1_SNAPSHOT));
+    write_word(0x10, flags2);
+    do_branch(true);
+}
+
+/**
+ * Ring opcodes — READ (for its UNDO snapshot), SAVE and RESTORE — diff or patch
+ * all of dynamic memory and move a record over the NoC, far more work than an
+ * instruction. None of it runs inside a slice: the first time the dispatcher
+ * meets one it ends the slice with pc on the opcode (ring_stage = RING_DUE), and
+ * the next launch does that work alone (ring_launch). When the opcode is then
+ * dispatched with RING_TAKEN it runs as usual. Launches whose state is not
+ * RING_DUE never touch the ring or the SAVE slots.
+ *
+ * A ring launch prints nothing. It leaves RING_TAKEN (READ still to run) or
+ * RING_RAN (SAVE / RESTORE done) until the next slice, so the host can tell its
+ * empty output from the game falling silent (zork_state.ring_launched).
+ *
+ * Returns true when the slice has to end here.
+ */
+static bool ring_op_due(zbyte* op_pc) {
+    if (ring_stage == RING_TAKEN) {
+        ring_stage = RING_NONE;
+        return false;
+    }
+    ring_stage = RING_DUE;
+    pc = op_pc;
+    return true;
+}
+
+/**
+ * VERIFY — resumable story checksum.
+ *
+ * The V3 checksum is the 16-bit sum of the story bytes from 0x40 up to the file
+ * length (header word 0x1A * 2), compared with header word 0x1C. It has to cover
+ * the original image, not L1 where dynamic memory has changed, so the story is
+ * read back from GAME_DRAM_ADDR one VERIFY_CHUNK at a time into L1_SNAPSHOT.
+ *
+ * Bytes are summed a word at a time in byte lanes: (w & 0x00FF00FF) and
+ * ((w >> 8) & 0x00FF00FF) each carry two 16-bit byte sums, which cannot
+ * overflow within 256 words, so the lanes are folded into verify_sum once per
+ * 1 KB block.
+ *
+ * One chunk per batch keeps VERIFY inside the watchdog budget: while the sum is
+ * incomplete, VERIFY rewinds pc to itself and ends the batch, and the next batch
+ * continues from verify_pos. The result is cached in ZMachineState against the
+ * story's release/checksum, so later VERIFYs branch at once.
+ */
+constexpr uint32_t VERIFY_CHUNK     = 8192;
+constexpr uint32_t VERIFY_IMAGE_MAX = 87040;  // Game tensor size (GAME_PAD on the host)
+constexpr uint32_t VERIFY_UNKNOWN   = 0;
+constexpr uint32_t VERIFY_GOOD      = 1;
+constexpr uint32_t VERIFY_BAD       = 2;
+
+static inline uint32_t fold_lanes(uint32_t lanes) {
+    return (lanes & 0xFFFF) + (lanes >> 16);
+}
+
+/**
+ * VERIFY opcode (0OP 0x0D) — branch if the story checksum matches.
+ * Returns false if the sum is still in progress and the batch should end.
+ */
+static bool op_verify() {
+    uint32_t key = ((uint32_t)read_word(0x02) << 16) | read_word(0x1C);
+    if (verify_key != key) {
+        verify_key = key;
+        verify_result = VERIFY_UNKNOWN;
+        verify_pos = 0;
+        verify_sum = 0;
+    }
+
+    if (verify_result == VERIFY_UNKNOWN) {
+        uint32_t file_len = (uint32_t)read_word(0x1A) * 2;
+        if (file_len < 0x40 || file_len > VERIFY_IMAGE_MAX) {
+            // Longer stories are truncated in the game tensor: cannot match
+            verify_result = VERIFY_BAD;
+        } else {
+            uint32_t len = file_len - verify_pos;
+            if (len > VERIFY_CHUNK) len = VERIFY_CHUNK;
+            noc_async_read(get_noc_addr(0, 0, GAME_DRAM_ADDR + verify_pos), L1_SNAPSHOT,
+                           ((len + 31) / 32) * 32);
+            noc_async_read_barrier();
+
+            const zbyte* buf = reinterpret_cast<const zbyte*>(L1_SNAPSHOT);
+            uint32_t i = (verify_pos == 0) ? 0x40 : 0;  // Header is not summed
+            uint32_t words_end = len & ~3u;
+            uint32_t sum = verify_sum;
+            while (i < words_end) {
+                uint32_t block_end = (i + 1024 < words_end) ? i + 1024 : words_end;
+                uint32_t even = 0;
+                uint32_t odd = 0;
+                for (; i < block_end; i += 4) {
+                    uint32_t w = *reinterpret_cast<const uint32_t*>(buf + i);
+                    even += w & 0x00FF00FF;
+                    odd += (w >> 8) & 0x00FF00FF;
+                }
+                sum += fold_lanes(even) + fold_lanes(odd);
+            }
+            for (; i < len; i++) {
+                sum += buf[i];
+            }
+            verify_sum = sum;
+            verify_pos += len;
+
+            if (verify_pos < file_len) {
+                pc--;  // Re-execute VERIFY next batch
+                return false;
+            }
+            verify_result = ((verify_sum & 0xFFFF) == read_word(0x1C)) ? VERIFY_GOOD : VERIFY_BAD;
+        }
+    }
+
+    do_branch(verify_result == VERIFY_GOOD);
+    return true;
+}
+#endif
+
+#ifdef ZORK_FUSE
+/**
+ * Superinstructions — fused handlers for the hottest stack-through sequences.
+ *
+ * Measured with ttlang/opcode_pairs.py (zork1/2/3, 15-command script). The
+ * adjacent pairs where one instruction stores to the stack and the next pops
+ * it again are, as a share of all executed pairs:
+ *   LOADB -> sp ; STOREB arr idx sp     12-17%  (byte-copy loop)
+ *     ... ; DEC_CHK idx 0 ?loop           8-11% as the full triple
+ *   MUL -> sp   ; ADD sp n -> var         4-6%   (table-row address arithmetic)
+ *   LOADW -> sp ; STOREW arr idx sp       3-4%
+ *   LOADW -> sp ; JE sp n / JZ sp         1-2%   (4% in Planetfall)
+ * PUSH ; CALL and GET_PROP ; JZ/JE measure below 0.2% and are not fused.
+ *
+ * op_loadb(), op_loadw() and op_mul() call fuse_stack_consumer() when their
+ * store target is the stack. If the next instruction is one of the consumers
+ * above and actually reads the stack, it is decoded and executed right here
+ * with the value forwarded through fwd_value: no push, no pop, no second trip
+ * through the main dispatch. Anything else returns false and the producer
+ * pushes as usual. Compiled in only when the host passes ZORK_FUSE.
+ */
+
+/**
+ * True if a VAR-form instruction whose operands start at p reads the stack.
+ */
+static bool var_operands_read_stack(zbyte specifier, const zbyte* p) {
+    for (int i = 6; i >= 0; i -= 2) {
+        int type = (specifier >> i) & 0x03;
+        if (type == 3) break;
+        if (type == 2 && *p == 0) return true;
+        p += (type == 0) ? 2 : 1;
+    }
+    return false;
+}
+
+static bool fuse_stack_consumer(zword value) {
+    zbyte next = pc[0];
+    bool reads_stack;
+
+    if (next < 0x80) {
+        // Long-form JE / ADD: either operand may be the stack
+        zbyte op_num = next & 0x1f;
+        if (op_num != 0x01 && op_num != 0x14) return false;
+        reads_stack = ((next & 0x40) && pc[1] == 0) || ((next & 0x20) && pc[2] == 0);
+    } else if (next == 0xA0) {
+        // JZ with a variable operand
+        reads_stack = (pc[1] == 0);
+    } else if (next == 0xC1 || next == 0xD4 || next == 0xE1 || next == 0xE2) {
+        // JE / ADD in VAR form, STOREW, STOREB
+        reads_stack = var_operands_read_stack(pc[1], pc + 2);
+    } else {
+        return false;
+    }
+    if (!reads_stack) return false;
+
+    CODE_BYTE(next);
+    if (opcode_track_count < 50) {
+        first_opcodes[opcode_track_count++] = next;
+    }
+    zargc = 0;
+    fwd_value = value;
+    fwd_live = true;
+    if (next < 0x80) {
+        load_operand((next & 0x40) ? 2 : 1);
+        load_operand((next & 0x20) ? 2 : 1);
+    } else if (next == 0xA0) {
+        load_operand(2);
+    } else {
+        zbyte specifier;
+        CODE_BYTE(specifier);
+        load_all_operands(specifier);
+    }
+
+    if (next == 0xA0) {
+        op_jz();
+    } else if (next == 0xE1) {
+        op_storew();
+    } else if (next == 0xE2) {
+        op_storeb();
+    } else if ((next & 0x1f) == 0x01) {
+        op_je();
+    } else {
+        op_add();
+    }
+    fused_extra++;
+
+    // Copy loops close with the counter step: run a long-form DEC_CHK/INC_CHK
+    // in the same dispatch, completing the LOADB/STOREB/DEC_CHK triple.
+    if ((next == 0xE1 || next == 0xE2) && pc[0] < 0x80 &&
+        ((pc[0] & 0x1f) == 0x04 || (pc[0] & 0x1f) == 0x05)) {
+        CODE_BYTE(next);
+        if (opcode_track_count < 50) {
+            first_opcodes[opcode_track_count++] = next;
+        }
+        zargc = 0;
+        load_operand((next & 0x40) ? 2 : 1);
+        load_operand((next & 0x20) ? 2 : 1);
+        if ((next & 0x1f) == 0x04) {
+            op_dec_chk();
+        } else {
+            op_inc_chk();
+        }
+        fused_extra++;
+    }
+    return true;
+}
+#endif
+
 /**
  * Main interpreter loop - based on Frotz's interpret()
  *
@@ -1401,6 +2299,25 @@ static void interpret(uint32_t max_instructions) {
                 case 3:  // PRINT_RET - like Ruby: puts "text"; return true
                     op_print_ret();
                     break;
+#ifdef STATE_DRAM_ADDR
+                case 5:  // SAVE - branch if saved to the selected slot
+                    if (ring_op_due(pc - 1)) return;
+                    op_save();
+                    break;
+                case 6:  // RESTORE - resume at the slot's SAVE, branching true
+                    if (ring_op_due(pc - 1)) return;
+                    op_restore();
+                    break;
+                case 13: // VERIFY - may span batches; ends this one if unfinished
+                    if (!op_verify()) return;
+                    break;
+#else
+                case 5:  // SAVE / RESTORE / VERIFY - need the state tensor: fail
+                case 6:
+                case 13:
+                    do_branch(false);
+                    break;
+#endif
                 case 11: // NEW_LINE - like Ruby: puts
                     op_new_line();
                     break;
@@ -1410,9 +2327,21 @@ static void interpret(uint32_t max_instructions) {
             }
         } else {
             // VAR opcodes (variable number of operands)
+#ifdef STATE_DRAM_ADDR
+            // READ's snapshot is taken before its operands are decoded (they may pop)
+            if (opcode == 0xE4 && ring_op_due(pc - 1)) return;
+#endif
             zbyte specifier1;
             CODE_BYTE(specifier1);
-            load_all_operands(specifier1);
+            if (opcode == 0xEC || opcode == 0xFA) {
+                // call_vs2 / call_vn2: a second specifier byte, up to 8 operands
+                zbyte specifier2;
+                CODE_BYTE(specifier2);
+                load_all_operands(specifier1);
+                if (zargc == 4) load_all_operands(specifier2);
+            } else {
+                load_all_operands(specifier1);
+            }
 
             zbyte op_num = opcode - 0xc0;
             // op_num 0x00-0x1F: 2OP opcodes in VAR encoding (0xC0-0xDF)
@@ -1520,9 +2449,35 @@ static void interpret(uint32_t max_instructions) {
                     break;
             }
         }
+
+#ifdef ZORK_FUSE
+        // Fused consumers count against the batch budget like any other instruction
+        instructions += fused_extra;
+        fused_extra = 0;
+#endif
+#ifdef ZORK_ON_STEP
+        // Host fuzz target (zork_fuzz.cpp) checks the VM after every instruction
+        ZORK_ON_STEP();
+#endif
     }
 }
 
+#ifdef STATE_DRAM_ADDR
+/**
+ * A launch for the ring opcode the last slice stopped at (see ring_op_due):
+ * READ's UNDO snapshot, or the SAVE / RESTORE itself. Nothing else runs.
+ */
+static void ring_launch() {
+    ring_stage = RING_TAKEN;
+    if (*pc == 0xE4) {
+        undo_snapshot(pc);   // READ itself runs at the start of the next slice
+    } else {
+        interpret(1);
+        ring_stage = RING_RAN;
+    }
+}
+#endif
+
 /**
  * Helper to output hex digits
  */
@@ -1568,10 +2523,22 @@ static void output_opcode_stats() {
  * (which is re-zeroed each kernel invocation), producing garbled output.
  */
 static void save_state(ZMachineState* state) {
+    globals_flush();  // The dynamic-memory copy after this must see current globals
     state->pc_offset = (uint32_t)(pc - memory);  // Convert pointer to offset
     state->sp = sp;
     state->frame_sp = frame_sp;
     state->finished = finished;
+    state->undo_head = undo_head;
+    state->undo_count = undo_count;
+    state->save_slot = save_slot;
+    for (uint32_t i = 0; i < SAVE_SLOTS; i++) {
+        state->save_dir[i] = save_dir[i];
+    }
+    state->verify_key = verify_key;
+    state->verify_result = verify_result;
+    state->verify_pos = verify_pos;
+    state->verify_sum = verify_sum;
+    state->ring_stage = ring_stage;
     // out_pos intentionally NOT saved — each batch outputs from position 0
 
     // Only copy the live portion of the stack (sp entries, not the full 1024).
@@ -1584,9 +2551,6 @@ static void save_state(ZMachineState* state) {
     // Same for call frames: only save the live frame_sp entries.
     for (uint32_t i = 0; i < frame_sp && i < 64; i++) {
         state->frames[i] = frames[i];
-        if (state->frames[i].ret_pc != nullptr) {
-            state->frames[i].ret_pc = (zbyte*)(state->frames[i].ret_pc - memory);
-        }
     }
 }
 
@@ -1601,6 +2565,17 @@ static void load_state(const ZMachineState* state) {
     sp = state->sp;
     frame_sp = state->frame_sp;
     finished = state->finished;
+    undo_head = state->undo_head;
+    undo_count = state->undo_count;
+    save_slot = state->save_slot;
+    for (uint32_t i = 0; i < SAVE_SLOTS; i++) {
+        save_dir[i] = state->save_dir[i];
+    }
+    verify_key = state->verify_key;
+    verify_result = state->verify_result;
+    verify_pos = state->verify_pos;
+    verify_sum = state->verify_sum;
+    ring_stage = state->ring_stage;
     // out_pos intentionally NOT restored — stays at 0 (set by kernel_main)
 
     // Only restore the live stack entries saved by save_state().
@@ -1611,9 +2586,6 @@ static void load_state(const ZMachineState* state) {
     // Only restore the live call frames saved by save_state().
     for (uint32_t i = 0; i < state->frame_sp && i < 64; i++) {
         frames[i] = state->frames[i];
-        if (frames[i].ret_pc != nullptr) {
-            frames[i].ret_pc = memory + (uint32_t)frames[i].ret_pc;
-        }
     }
 }
 
@@ -1650,8 +2622,12 @@ void kernel_main() {
     //   0x26000  L1_STACK   —   2048 B  Z-machine stack (1024 × zword = 2 KB)
     //   0x26800  L1_FRAMES  —   2432 B  call frames (64 × sizeof(Frame) ≈ 38 B each)
     //   0x27200  L1_OPCODES —     64 B  opcode trace buffer (first_opcodes[50])
+    //   0x27400  L1_GLOBALS —    480 B  native-endian shadow of the 240 globals
+    //   0x27600  L1_ROUTINES—   2176 B  routine header cache (64 × RoutineHeader)
     //   0x30000  L1_OUT     —  16384 B  output text buffer
-    //   0x34000  L1_INPUT   —   1024 B  input command (null-terminated)
+    //   0x34000  L1_INPUT   —   1024 B  input command (null-terminated) + host command block
+    //   0x38000  L1_PRISTINE—  32768 B  pristine dynamic memory (UNDO/SAVE, loaded on demand)
+    //   0x40000  L1_SNAPSHOT—   8192 B  snapshot record staging (UNDO ring, SAVE slots)
     //   0x50000  L1_STATE   —  ~10 KB   ZMachineState (only when STATE_DRAM_ADDR defined)
     //
     // Gap check: L1_STACK (0x26000) starts after game data ends (0x10000+0x15400=0x25400).
@@ -1660,6 +2636,8 @@ void kernel_main() {
     constexpr uint32_t L1_STACK   = 0x26000;   // stack[1024] → 2048 bytes
     constexpr uint32_t L1_FRAMES  = 0x26800;   // frames[64]  → sizeof(Frame)*64 bytes
     constexpr uint32_t L1_OPCODES = 0x27200;   // first_opcodes[50] → 64 bytes (padded)
+    constexpr uint32_t L1_GLOBALS = 0x27400;   // globals[240] → 480 bytes
+    constexpr uint32_t L1_ROUTINES = 0x27600;  // routine_cache[64] → 2176 bytes
     constexpr uint32_t L1_OUT     = 0x30000;
     constexpr uint32_t L1_INPUT   = 0x34000;
     constexpr uint32_t GAME_SIZE  = 87040;
@@ -1671,6 +2649,12 @@ void kernel_main() {
     stack        = reinterpret_cast<zword*>(L1_STACK);
     frames       = reinterpret_cast<Frame*>(L1_FRAMES);
     first_opcodes = reinterpret_cast<zbyte*>(L1_OPCODES);
+    globals      = reinterpret_cast<zword*>(L1_GLOBALS);
+    globals_base = globals - 0x10;
+    routine_cache = reinterpret_cast<RoutineHeader*>(L1_ROUTINES);
+    for (uint32_t i = 0; i < ROUTINE_CACHE_SIZE; i++) {
+        routine_cache[i].addr = 0;
+    }
 
     // Step 1: Issue all DRAM→L1 reads in one pass, then a single barrier.
     // Previously each 4KB game chunk had its own barrier (22 barriers for the
@@ -1688,33 +2672,27 @@ void kernel_main() {
         offset += chunk;
     }
 
+#ifndef STATE_DRAM_ADDR
     // Input read batched with game reads — single barrier covers both
     uint64_t input_src = get_noc_addr(0, 0, INPUT_DRAM_ADDR);
     noc_async_read(input_src, L1_INPUT, INPUT_SIZE);
-    noc_async_read_barrier();  // one barrier covers all 22 game chunks + input
+#endif
+    noc_async_read_barrier();  // one barrier covers all 22 game chunks (+ input)
 
     memory = (zbyte*)L1_GAME;
     output = (char*)L1_OUT;
     input = (char*)L1_INPUT;
 
-    // Initialize opcode tracking
-    opcode_track_count = 0;
-
     // Initialize global Z-machine constants
     abbrev_table = read_word(0x18);      // Abbreviations table
     global_vars_addr = read_word(0x0C);  // Global variables table
     dictionary_addr = read_word(0x08);   // Dictionary table
-
-    // Always reset out_pos = 0 so this batch's output fills the buffer from
-    // the beginning. The Python host reads the buffer after each batch and
-    // concatenates results. This avoids writing past L1_OUT (re-zeroed each
-    // kernel invocation) and keeps the output logic simple.
-    out_pos = 0;
+    load_alphabet();                     // Z-character tables (custom in V5+)
 
 #ifdef STATE_DRAM_ADDR
     // BATCHED EXECUTION MODE: Load previous state if exists.
     //
-    // State buffer layout in the 32 KB DRAM tensor (STATE_DRAM_ADDR):
+    // State buffer layout in each session's 96 KB of the DRAM tensor (state_dram_base):
     //   [0 .. STRUCT_SIZE-1]              : ZMachineState struct (PC, stack, frames, …)
     //   [DYN_OFFSET .. DYN_OFFSET+dyn-1]  : Dynamic game memory snapshot
     //                                        (bytes 0..read_word(0x0E)-1 of game memory)
@@ -1730,97 +2708,187 @@ void kernel_main() {
     constexpr uint32_t STRUCT_SIZE = sizeof(ZMachineState);
     constexpr uint32_t DYN_OFFSET  = ((STRUCT_SIZE + 31) / 32) * 32;
 
-    // Read the full 32 KB state tensor — covers struct + up to ~27 KB of dynamic memory.
-    // Dynamic memory for Zork 1.z3 is 11282 bytes; total = ~16434 bytes, within 32 KB.
+    // Read the first 32 KB of the state tensor — covers struct + up to ~27 KB of dynamic
+    // memory. Dynamic memory for Zork 1.z3 is 11282 bytes; total = ~16434 bytes, within
+    // 32 KB. The UNDO ring and SAVE slots after it (ring_dram_base) are only touched
+    // in ring launches (ring_stage == RING_DUE) and on a host UNDO command.
     constexpr uint32_t STATE_READ_SIZE = 32 * 1024;
 
-    // Read state from DRAM into L1 — single barrier (game+input reads already done above)
-    uint64_t state_dram_noc_addr = get_noc_addr(0, 0, STATE_DRAM_ADDR);
-    noc_async_read(state_dram_noc_addr, L1_STATE, STATE_READ_SIZE);
-    noc_async_read_barrier();
+    // memory[0..dyn) still holds the story's own dynamic memory until a session runs
+    bool dynamic_pristine = true;
+    pristine_loaded = false;
 
-    ZMachineState* state = (ZMachineState*)L1_STATE;
+    for (uint32_t session = 0; session < ZORK_SESSIONS; session++) {
+#ifdef RING_DRAM_ADDR
+        state_dram_base = STATE_DRAM_ADDR + session * UNDO_RING_OFFSET;
+        ring_dram_base = RING_DRAM_ADDR + session * (SESSION_STATE_SIZE - UNDO_RING_OFFSET);
+#else
+        state_dram_base = STATE_DRAM_ADDR + session * SESSION_STATE_SIZE;
+        ring_dram_base = state_dram_base + UNDO_RING_OFFSET;
+#endif
+
+        // Read this session's input and state from DRAM into L1 — one barrier for both
+        uint64_t input_src = get_noc_addr(0, 0, INPUT_DRAM_ADDR + session * SESSION_INPUT_SIZE);
+        noc_async_read(input_src, L1_INPUT, INPUT_SIZE);
+        uint64_t state_dram_noc_addr = get_noc_addr(0, 0, state_dram_base);
+        noc_async_read(state_dram_noc_addr, L1_STATE, STATE_READ_SIZE);
+        noc_async_read_barrier();
 
-    if (state->instruction_count > 0) {
-        // Resume: restore interpreter state from previous batch
-        // out_pos stays 0 (reset above) — fresh output buffer for this batch
-        load_state(state);
+        ZMachineState* state = (ZMachineState*)L1_STATE;
 
-        // Restore dynamic game memory (global vars, object attributes, flags).
-        // The game file reload above reset memory[0..dyn_size-1] to the original ROM;
-        // overwrite it with the state saved by the previous batch.
-        uint32_t dyn_size = (uint32_t)(((uint32_t)memory[0x0E] << 8) | (uint32_t)memory[0x0F]);
-        zbyte* dyn_src = reinterpret_cast<zbyte*>(L1_STATE + DYN_OFFSET);
-        for (uint32_t i = 0; i < dyn_size; i++) {
-            memory[i] = dyn_src[i];
+        // Per-session interpreter scratch
+        opcode_track_count = 0;
+#ifdef ZORK_FUSE
+        fwd_live = false;
+        fused_extra = 0;
+#endif
+
+        // Always reset out_pos = 0 so this batch's output fills the buffer from
+        // the beginning. The Python host reads the buffer after each batch and
+        // concatenates results. This avoids writing past L1_OUT (re-zeroed each
+        // kernel invocation) and keeps the output logic simple.
+        out_pos = 0;
+
+        if (state->instruction_count > 0) {
+            // Resume: restore interpreter state from previous batch
+            // out_pos stays 0 (reset above) — fresh output buffer for this batch
+            load_state(state);
+
+            // Restore dynamic game memory (global vars, object attributes, flags).
+            // The game file reload above reset memory[0..dyn_size-1] to the original ROM;
+            // overwrite it with the state saved by the previous batch.
+            uint32_t dyn_size = dynamic_size();
+            zbyte* dyn_src = reinterpret_cast<zbyte*>(L1_STATE + DYN_OFFSET);
+            for (uint32_t i = 0; i < dyn_size; i++) {
+                memory[i] = dyn_src[i];
+            }
+        } else {
+            // First batch: initialize the Z-machine interpreter from scratch
+            if (!dynamic_pristine) {
+                // An earlier session this launch changed the shared image: re-fetch
+                // the story's dynamic memory (the rounded tail is static, unchanged)
+                uint32_t dyn_size = dynamic_size();
+                noc_async_read(get_noc_addr(0, 0, GAME_DRAM_ADDR), L1_GAME,
+                               ((dyn_size + 31) / 32) * 32);
+                noc_async_read_barrier();
+            }
+            zword initial_pc = read_word(0x06);   // Initial PC from header byte 0x06
+            sp = 0;
+            frame_sp = 0;
+            finished = false;
+            pc = memory + initial_pc;
+            undo_head = 0;
+            undo_count = 0;
+            save_slot = 0;
+            for (uint32_t i = 0; i < SAVE_SLOTS; i++) {
+                save_dir[i].size = 0;
+            }
+            verify_key = 0;
+            verify_result = 0;
+            ring_stage = RING_NONE;
+            // instruction_count is already 0 in the zero-initialised state tensor
         }
-    } else {
-        // First batch: initialize the Z-machine interpreter from scratch
-        zword initial_pc = read_word(0x06);   // Initial PC from header byte 0x06
+        dynamic_pristine = false;
+
+        // Host commands: UNDO restores a ring snapshot and ends the batch there, so
+        // the next batch resumes at that turn's READ with the host's new input.
+        bool run_batch = true;
+        const HostCommand* host_cmd = reinterpret_cast<const HostCommand*>(L1_INPUT + HOST_CMD_OFFSET);
+        if (host_cmd->op == HOST_CMD_UNDO) {
+            undo_restore(host_cmd->arg);
+            run_batch = false;
+        } else if (host_cmd->op == HOST_CMD_SLOT && host_cmd->arg < SAVE_SLOTS) {
+            save_slot = host_cmd->arg;
+        }
+        headless = (host_cmd->flags & HOST_FLAG_HEADLESS) != 0;
+#else
+        opcode_track_count = 0;
+#ifdef ZORK_FUSE
+        fwd_live = false;
+        fused_extra = 0;
+#endif
+        out_pos = 0;
+
+        // SINGLE-SHOT MODE: Always initialize fresh — no state persistence.
+        // Use this for a single 40-instruction probe (testing/debugging).
+        zword initial_pc = read_word(0x06);
         sp = 0;
         frame_sp = 0;
         finished = false;
         pc = memory + initial_pc;
-        // instruction_count is already 0 in the zero-initialised state tensor
-    }
+#endif
+
+        // Globals shadow and frame base: taken after every way dynamic memory and
+        // the call stack can be set up above
+        globals_load();
+        set_frame_base();
+
+        // Run interpreter. Note: firmware watchdog limits execution time.
+        // QB2/Blackhole with new TT-Lang firmware (build 6745986192171285359) has a
+        // shorter watchdog than the original Blackhole session (build from Jan 2026).
+        // Binary search for stable instruction count:
+        //   interpret(10)  = completes cleanly, no output (not enough instructions)
+        //   interpret(100) = firmware watchdog triggered (hangs)
+        // Instruction count per batch: 10 (conservative, survives PRINT opcode).
+        // Empirical watchdog budget on QB2 / firmware 6745986192171285359:
+        //   interpret(10)  = completes reliably — safe even when PRINT fires because
+        //                    the Z-string decode loop completes within the watchdog window
+        //   interpret(20)  = HANGS at batch 3: PRINT Z-string decode adds overhead
+        //                    beyond the 20-iteration count, tips the watchdog
+        //   interpret(30)  = HANGS at batch 3 for same reason (worse)
+        //   interpret(40)  = was watchdog-safe WITHOUT state I/O (no PRINT)
+        //   interpret(45+) = firmware watchdog (hang)
+        // 10 batches × 10 = 100 instructions — sufficient for "West of House" opening text.
+#ifdef STATE_DRAM_ADDR
+        if (!run_batch) {
+            // UNDO batch: restored above
+        } else if (ring_stage == RING_DUE) {
+            ring_launch();
+        } else {
+            if (ring_stage == RING_RAN) ring_stage = RING_NONE;
+            interpret(ZORK_SLICE);
+        }
 #else
-    // SINGLE-SHOT MODE: Always initialize fresh — no state persistence.
-    // Use this for a single 40-instruction probe (testing/debugging).
-    zword initial_pc = read_word(0x06);
-    sp = 0;
-    frame_sp = 0;
-    finished = false;
-    pc = memory + initial_pc;
+        interpret(10);
 #endif
 
-    // Run interpreter. Note: firmware watchdog limits execution time.
-    // QB2/Blackhole with new TT-Lang firmware (build 6745986192171285359) has a
-    // shorter watchdog than the original Blackhole session (build from Jan 2026).
-    // Binary search for stable instruction count:
-    //   interpret(10)  = completes cleanly, no output (not enough instructions)
-    //   interpret(100) = firmware watchdog triggered (hangs)
-    // Instruction count per batch: 10 (conservative, survives PRINT opcode).
-    // Empirical watchdog budget on QB2 / firmware 6745986192171285359:
-    //   interpret(10)  = completes reliably — safe even when PRINT fires because
-    //                    the Z-string decode loop completes within the watchdog window
-    //   interpret(20)  = HANGS at batch 3: PRINT Z-string decode adds overhead
-    //                    beyond the 20-iteration count, tips the watchdog
-    //   interpret(30)  = HANGS at batch 3 for same reason (worse)
-    //   interpret(40)  = was watchdog-safe WITHOUT state I/O (no PRINT)
-    //   interpret(45+) = firmware watchdog (hang)
-    // 10 batches × 10 = 100 instructions — sufficient for "West of House" opening text.
-    interpret(10);
-
-    output[out_pos++] = '\0';
+        output[out_pos++] = '\0';
 
 #ifdef STATE_DRAM_ADDR
-    // Save updated state back to DRAM for the next batch.
-    // We executed 10 instructions in this invocation (interpret(10) above).
-    state->instruction_count += 10;
-    save_state(state);
-
-    // Save dynamic game memory (global vars, object attributes, flags) after the struct.
-    // dyn_size = header[0x0E] big-endian word = static memory base = 11282 for Zork 1.z3.
-    // Saving bytes 0..dyn_size-1 ensures the next batch restores them after reloading the ROM.
-    {
-        uint32_t dyn_size = (uint32_t)(((uint32_t)memory[0x0E] << 8) | (uint32_t)memory[0x0F]);
-        zbyte* dyn_dst = reinterpret_cast<zbyte*>(L1_STATE + DYN_OFFSET);
-        for (uint32_t i = 0; i < dyn_size; i++) {
-            dyn_dst[i] = memory[i];
+        // Save updated state back to DRAM for the next batch.
+        // We executed one slice in this invocation (interpret(ZORK_SLICE) above).
+        state->instruction_count += ZORK_SLICE;
+        save_state(state);
+
+        // Save dynamic game memory (global vars, object attributes, flags) after the struct.
+        // dyn_size = header[0x0E] big-endian word = static memory base = 11282 for Zork 1.z3.
+        // Saving bytes 0..dyn_size-1 ensures the next batch restores them after reloading the ROM.
+        {
+            uint32_t dyn_size = dynamic_size();
+            zbyte* dyn_dst = reinterpret_cast<zbyte*>(L1_STATE + DYN_OFFSET);
+            for (uint32_t i = 0; i < dyn_size; i++) {
+                dyn_dst[i] = memory[i];
+            }
+            // Write struct + dynamic memory to DRAM (rounded up to 32-byte alignment for NoC)
+            uint32_t total_state = DYN_OFFSET + dyn_size;
+            uint32_t state_write_size = ((total_state + 31) / 32) * 32;
+            noc_async_write(L1_STATE, state_dram_noc_addr, state_write_size);
         }
-        // Write struct + dynamic memory to DRAM (rounded up to 32-byte alignment for NoC)
-        uint32_t total_state = DYN_OFFSET + dyn_size;
-        uint32_t state_write_size = ((total_state + 31) / 32) * 32;
-        noc_async_write(L1_STATE, state_dram_noc_addr, state_write_size);
-        noc_async_write_barrier();
-    }
-#endif
 
+        // Use NoC to copy this session's output from L1 to its slice of the output buffer
+        uint32_t output_size = ((out_pos + 31) / 32) * 32;  // Round to 32-byte alignment
+        uint64_t output_dram_noc_addr =
+            get_noc_addr(0, 0, OUTPUT_DRAM_ADDR + session * SESSION_OUTPUT_SIZE);
+        noc_async_write(L1_OUT, output_dram_noc_addr, output_size);
+        noc_async_write_barrier();  // L1_STATE / L1_OUT are reused by the next session
+    }
+#else
     // Step 2: Use NoC to copy output from L1 to DRAM
     uint32_t output_size = ((out_pos + 31) / 32) * 32;  // Round to 32-byte alignment
     uint64_t output_dram_noc_addr = get_noc_addr(0, 0, OUTPUT_DRAM_ADDR);
     noc_async_write(L1_OUT, output_dram_noc_addr, output_size);
     noc_async_write_barrier();
+#endif
 
     // Done! Output and state transferred from L1 to DRAM
 }
@@ -0,0 +1,778 @@
+// SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * zork_lockstep.cpp — Many sessions per launch in SIMD lockstep, on the host build.
+ *
+ * Bulk bot play and exploration run hundreds of sessions that sit at the same
+ * PC running the same routine. zork_lockstep_launch() runs one launch for any
+ * number of sessions: ZORK_SLICE instructions each, with the states and text a
+ * zork_host_launch() per session would leave. It steps the sessions together
+ * instead of one after another:
+ *
+ *   register file  pc, sp, frame_sp and the current frame's locals, one array per
+ *                  register indexed by session (structure of arrays, LaneRegisters)
+ *   step           the sessions still in lockstep are grouped by PC. A group's
+ *                  instruction is decoded once from the story, then run 8 sessions
+ *                  at a time in AVX2 lanes: operand fetch (stack top, locals and
+ *                  big-endian globals gathered from the state blocks), arithmetic,
+ *                  compares and branch targets. Results, pushes, memory stores,
+ *                  calls and returns are then written back session by session.
+ *   divergence     sessions that branch apart form smaller groups. What is left of
+ *                  a group after its multiples of 8, down to a session alone at its
+ *                  PC, runs the same code one session at a time (Lanes1). A session
+ *                  whose next instruction the lanes do not run leaves lockstep and
+ *                  runs the rest of its slice in the kernel's own interpret(),
+ *                  through kernel_main() on its blocks. That is text output, READ,
+ *                  SAVE / RESTORE / VERIFY, a store into static memory, a call
+ *                  past 64 frames or a return to no frame. A session that starts
+ *                  its launch somewhere the lanes cannot resume (a fresh game, a
+ *                  host command, a ring launch) runs all of it there.
+ *
+ * Lanes work on the state blocks in place: the dynamic memory overlay is the
+ * session's memory, and static memory and code are read from one copy of the
+ * story. A launch of a session that stays in lockstep copies nothing, where
+ * kernel_main() reads 32 KB of state and writes the dynamic memory twice.
+ *
+ * Stack entries above sp and call frames above frame_sp are not saved by the
+ * kernel, so the state keeps what it had before the launch. The lanes log the
+ * old values of the entries and frames they write (LaneLog) and put back the
+ * ones that end up above sp / frame_sp.
+ *
+ * Built by ttlang/zork_lockstep.py (through zork_native.build) with
+ * ZORK_SESSIONS=1. Needs AVX2; zork_lockstep_supported() tells the driver.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+constexpr uint32_t LOCKSTEP_SLICE = 10;   // The scalar build's ZORK_SLICE
+
+// Instructions kernel_main() runs for a session: the rest of its slice
+static uint32_t lockstep_slice = LOCKSTEP_SLICE;
+#define ZORK_SLICE lockstep_slice
+
+#include "zork_host.cpp"
+
+extern "C" bool zork_lockstep_supported() { return __builtin_cpu_supports("avx2"); }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#include <immintrin.h>
+
+constexpr uint32_t LOCKSTEP_MAX_SESSIONS = 16384;  // State offsets fit the gathers' int32
+constexpr uint32_t CODE_END = 86000;             // interpret() stops here; reads past it are 0
+constexpr uint32_t INSN_MAX = 24;                // Longest instruction (VAR call, 8 large operands)
+constexpr uint32_t DYN_OFFSET = ((sizeof(ZMachineState) + 31) / 32) * 32;
+constexpr uint32_t ST_STACK = offsetof(ZMachineState, stack);
+constexpr uint32_t ST_FRAMES = offsetof(ZMachineState, frames);
+constexpr uint32_t FRAME_LOCALS = offsetof(Frame, locals);
+
+/** Counters over all launches, read by the driver. */
+struct LockstepStats {
+    uint64_t sessions;   // session launches
+    uint64_t lanes;      // instructions run 8 sessions at a time in AVX2 lanes
+    uint64_t tails;      // instructions run one session at a time by the lockstep code
+    uint64_t kernel;     // session launches that ran all or part of the slice in kernel_main()
+    uint64_t groups;     // instructions decoded (one per group per step)
+};
+
+enum LaneOp : uint8_t {
+    LANE_KERNEL,       // not run in lanes: the session leaves lockstep
+    LANE_NOP,          // operands only (stubbed object ops, opcodes the kernel skips)
+    LANE_STORE_ZERO,   // stubs that store 0: get_prop, get_parent, get_prop_len, ...
+    LANE_BRANCH,       // je, jl, jg, jz, test; jin, test_attr, get_sibling, get_child never
+    LANE_ARITH,        // add, sub, mul, div, mod, and, or, not, random -> store
+    LANE_INC, LANE_DEC, LANE_INC_CHK, LANE_DEC_CHK,
+    LANE_STORE, LANE_LOAD, LANE_PUSH, LANE_PULL,
+    LANE_LOADW, LANE_LOADB, LANE_STOREW, LANE_STOREB,
+    LANE_JUMP, LANE_CALL, LANE_RET,
+};
+
+enum LaneTest : uint8_t { TEST_NEVER, TEST_JE, TEST_JL, TEST_JG, TEST_JZ, TEST_BITS };
+enum LaneArith : uint8_t { ARITH_ADD, ARITH_SUB, ARITH_MUL, ARITH_DIV, ARITH_MOD,
+                           ARITH_AND, ARITH_OR, ARITH_NOT, ARITH_RANDOM };
+
+/** One instruction as interpret() decodes it, with the operands still unread. */
+struct LaneInsn {
+    LaneOp op;
+    uint8_t sub;              // LaneTest / LaneArith
+    uint8_t argc;
+    uint8_t type[8];          // 0 large constant, 1 small constant, 2 variable
+    zword value[8];           // the constant, or the variable number
+    zbyte var;                // indirect variable (inc, dec, store, load, pull)
+    zbyte store;              // store variable
+    bool branches;
+    bool branch_on_true;
+    int16_t offset;           // branch offset (0 / 1 return false / true)
+    zword ret;                // LANE_RET with no operand: rtrue / rfalse
+    uint32_t next;            // PC past the whole instruction
+};
+
+// The launch: story image, geometry and the sessions' state blocks
+static uint8_t lane_rom[HOST_GAME_SIZE + 8];   // memory[] as the kernel loads it, static part
+static const uint8_t* lane_rom_story;          // story lane_rom was filled from
+static uint32_t lane_dyn;                      // dynamic memory size (header 0x0E)
+static uint32_t lane_globals;                  // globals table (header 0x0C)
+static uint8_t* lane_states;
+
+/** Old values of what a session's lanes wrote above the kernel's saved range. */
+struct LaneLog {
+    uint32_t stack_count;
+    uint16_t stack_index[LOCKSTEP_SLICE];
+    zword stack_old[LOCKSTEP_SLICE];
+    uint64_t frames_saved;                     // bit k: frames[k] below
+    uint32_t frame_count;
+    uint8_t frame_slot[LOCKSTEP_SLICE + 1];
+    Frame frame_old[LOCKSTEP_SLICE + 1];
+};
+
+enum LaneMode : uint8_t {
+    MODE_KERNEL,     // the whole launch runs in kernel_main()
+    MODE_LOCKSTEP,   // in lockstep
+    MODE_LEFT,       // left lockstep after `done` instructions; kernel_main() runs the rest
+};
+
+/** The structure-of-arrays register file, one entry per session. */
+struct LaneRegisters {
+    std::vector<uint32_t> pc;         // PC offset
+    std::vector<uint32_t> sp;
+    std::vector<uint32_t> frame_sp;
+    std::vector<uint32_t> locals;     // offset of frames[frame_sp - 1].locals, less 2, in lane_states
+    std::vector<uint32_t> base;       // offset of the session's state block in lane_states
+    std::vector<uint32_t> done;       // instructions run in lockstep this launch
+    std::vector<uint8_t> mode;        // LaneMode
+    std::vector<LaneLog> log;
+};
+static LaneRegisters regs;
+
+static inline uint8_t* lane_state(uint32_t lane) { return lane_states + regs.base[lane]; }
+static inline ZMachineState* lane_zstate(uint32_t lane) {
+    return reinterpret_cast<ZMachineState*>(lane_state(lane));
+}
+
+static inline void lane_set_frame(uint32_t lane, uint32_t frame_sp) {
+    regs.frame_sp[lane] = frame_sp;
+    regs.locals[lane] = regs.base[lane] + ST_FRAMES + (frame_sp - 1) * sizeof(Frame) + FRAME_LOCALS - 2;
+}
+
+/** memory[addr] as the kernel sees it for this session (addr < HOST_GAME_SIZE). */
+static inline zbyte lane_image(uint32_t lane, uint32_t addr) {
+    return addr < lane_dyn ? lane_state(lane)[DYN_OFFSET + addr] : lane_rom[addr];
+}
+
+/** read_word() for this session. */
+static inline zword lane_word(uint32_t lane, uint32_t addr) {
+    if (addr >= CODE_END) return 0;
+    return static_cast<zword>(lane_image(lane, addr) << 8 | lane_image(lane, addr + 1));
+}
+
+/** Keep frames[slot] as it was before the launch, the first time a lane writes it. */
+static inline void lane_touch_frame(uint32_t lane, uint32_t slot) {
+    LaneLog& log = regs.log[lane];
+    if (log.frames_saved >> slot & 1) return;
+    log.frames_saved |= uint64_t(1) << slot;
+    log.frame_slot[log.frame_count] = static_cast<uint8_t>(slot);
+    memcpy(&log.frame_old[log.frame_count++], &lane_zstate(lane)->frames[slot], sizeof(Frame));
+}
+
+/** write_variable() for this session. */
+static inline void lane_write(uint32_t lane, zbyte var, zword value) {
+    if (var == 0) {
+        uint32_t sp = regs.sp[lane];
+        if (sp < 1024) {
+            zword* slot = &lane_zstate(lane)->stack[sp];
+            LaneLog& log = regs.log[lane];
+            log.stack_index[log.stack_count] = static_cast<uint16_t>(sp);
+            log.stack_old[log.stack_count++] = *slot;
+            *slot = value;
+            regs.sp[lane] = sp + 1;
+        }
+    } else if (var < 0x10) {
+        lane_touch_frame(lane, regs.frame_sp[lane] - 1);
+        memcpy(lane_states + regs.locals[lane] + var * 2, &value, 2);
+    } else {
+        uint8_t* g = lane_state(lane) + DYN_OFFSET + lane_globals + (var - 0x10) * 2;
+        g[0] = static_cast<uint8_t>(value >> 8);
+        g[1] = static_cast<uint8_t>(value);
+    }
+}
+
+/** A return (ret, rtrue, rfalse, a branch to 0 / 1) for this session, as op_ret(). */
+static inline void lane_return(uint32_t lane, zword value) {
+    uint32_t frame_sp = regs.frame_sp[lane] - 1;
+    const Frame& frame = lane_zstate(lane)->frames[frame_sp];
+    uint32_t ret_pc = frame.ret_pc;
+    zbyte store = frame.store_var;
+    lane_set_frame(lane, frame_sp);
+    regs.pc[lane] = ret_pc;
+    lane_write(lane, store, value);
+}
+
+/** op_call() for this session, the arguments already fetched. */
+static inline void lane_call(uint32_t lane, const LaneInsn& in, const uint32_t* args) {
+    zword routine = static_cast<zword>(args[0]);
+    if (routine == 0) {
+        lane_write(lane, in.store, 0);
+        regs.pc[lane] = in.next;
+        return;
+    }
+    uint32_t byte_addr = routine * 2u;
+    if (byte_addr >= CODE_END) {
+        regs.pc[lane] = in.next;
+        return;
+    }
+    uint32_t num_locals = lane_rom[byte_addr] > 15 ? 15 : lane_rom[byte_addr];
+    uint32_t slot = regs.frame_sp[lane];
+    lane_touch_frame(lane, slot);
+    Frame& frame = lane_zstate(lane)->frames[slot];
+    frame.ret_pc = in.next;
+    frame.store_var = in.store;
+    frame.num_locals = static_cast<zbyte>(num_locals);
+    for (uint32_t i = 0; i < 15; i++) {
+        frame.locals[i] = i < num_locals
+            ? static_cast<zword>(lane_rom[byte_addr + 1 + i * 2] << 8 | lane_rom[byte_addr + 2 + i * 2]) : 0;
+    }
+    uint32_t num_args = in.argc - 1u < num_locals ? in.argc - 1u : num_locals;
+    for (uint32_t i = 0; i < num_args; i++) {
+        frame.locals[i] = static_cast<zword>(args[i + 1]);
+    }
+    lane_set_frame(lane, slot + 1);
+    regs.pc[lane] = byte_addr + 1 + num_locals * 2;
+}
+
+/**
+ * Decode the instruction at pc as interpret() would, without reading any
+ * variable. Anything the lanes do not run comes back as LANE_KERNEL.
+ */
+static LaneInsn lane_decode(uint32_t pc) {
+    LaneInsn in = {};
+    const zbyte* code = lane_rom + pc;
+    const zbyte* p = code + 1;
+    zbyte opcode = code[0];
+    uint32_t need = 0;          // operands the op reads (fewer would read stale zargs)
+    auto operand = [&](uint32_t type) {
+        in.type[in.argc] = static_cast<uint8_t>(type);
+        if (type == 0) {
+            in.value[in.argc] = static_cast<zword>(p[0] << 8 | p[1]);
+            p += 2;
+        } else {
+            in.value[in.argc] = *p++;
+        }
+        in.argc++;
+    };
+    auto specifier = [&](zbyte spec) {
+        for (int i = 6; i >= 0; i -= 2) {
+            uint32_t type = (spec >> i) & 0x03;
+            if (type == 3) break;
+            operand(type);
+        }
+    };
+    auto store = [&] { in.store = *p++; };
+    auto branch = [&](LaneTest test) {
+        if (in.op == LANE_BRANCH) in.sub = test;
+        in.branches = true;
+        zbyte b = *p++;
+        in.branch_on_true = (b & 0x80) != 0;
+        if (b & 0x40) {
+            in.offset = b & 0x3F;
+        } else {
+            int16_t offset = static_cast<int16_t>((b & 0x3F) << 8 | *p++);
+            if (offset & 0x2000) offset = static_cast<int16_t>(offset | 0xC000);
+            in.offset = offset;
+        }
+    };
+    auto arith = [&](LaneArith a, uint32_t n) { in.op = LANE_ARITH; in.sub = a; need = n; store(); };
+    auto indirect = [&](LaneOp op, uint32_t n) { in.op = op; need = n; };
+
+    uint32_t op_num;
+    if (opcode < 0x80) {
+        operand((opcode & 0x40) ? 2 : 1);
+        operand((opcode & 0x20) ? 2 : 1);
+        op_num = opcode & 0x1F;
+    } else if (opcode < 0xB0) {
+        operand((opcode >> 4) & 0x03);
+        op_num = 0x100 | (opcode & 0x0F);   // 1OP
+    } else if (opcode < 0xC0) {
+        op_num = 0x200 | (opcode - 0xB0);   // 0OP
+    } else {
+        zbyte spec1 = *p++;
+        if (opcode == 0xEC || opcode == 0xFA) {
+            zbyte spec2 = *p++;
+            specifier(spec1);
+            if (in.argc == 4) specifier(spec2);
+        } else {
+            specifier(spec1);
+        }
+        op_num = opcode - 0xC0;
+        // 2OP opcodes the VAR switch in interpret() leaves out do nothing there
+        if (op_num == 0x00) op_num = 0x20;
+        if (op_num == 0x12 || op_num == 0x13 || (op_num > 0x18 && op_num < 0x20)) op_num = 0x3F;
+    }
+
+    in.op = LANE_NOP;
+    switch (op_num) {
+        // 2OP, long and VAR form
+        case 0x01: in.op = LANE_BRANCH; branch(TEST_JE); break;
+        case 0x02: in.op = LANE_BRANCH; branch(TEST_JL); need = 2; break;
+        case 0x03: in.op = LANE_BRANCH; branch(TEST_JG); need = 2; break;
+        case 0x04: indirect(LANE_DEC_CHK, 2); branch(TEST_NEVER); break;
+        case 0x05: indirect(LANE_INC_CHK, 2); branch(TEST_NEVER); break;
+        case 0x06: in.op = LANE_BRANCH; branch(TEST_NEVER); break;   // jin
+        case 0x07: in.op = LANE_BRANCH; branch(TEST_BITS); need = 2; break;
+        case 0x08: arith(ARITH_OR, 2); break;
+        case 0x09: arith(ARITH_AND, 2); break;
+        case 0x0A: in.op = LANE_BRANCH; branch(TEST_NEVER); break;   // test_attr
+        case 0x0D: indirect(LANE_STORE, 2); break;
+        case 0x0F: in.op = LANE_LOADW; need = 2; store(); break;
+        case 0x10: in.op = LANE_LOADB; need = 2; store(); break;
+        case 0x11: in.op = LANE_STORE_ZERO; store(); break;          // get_prop
+        case 0x12: case 0x13: in.op = LANE_STORE_ZERO; store(); break;  // long form only
+        case 0x14: arith(ARITH_ADD, 2); break;
+        case 0x15: arith(ARITH_SUB, 2); break;
+        case 0x16: arith(ARITH_MUL, 2); break;
+        case 0x17: arith(ARITH_DIV, 2); break;
+        case 0x18: arith(ARITH_MOD, 2); break;
+        // VAR
+        case 0x20: in.op = LANE_CALL; need = 1; store(); break;
+        case 0x21: in.op = LANE_STOREW; need = 3; break;
+        case 0x22: in.op = LANE_STOREB; need = 3; break;
+        case 0x24: case 0x25: case 0x26: in.op = LANE_KERNEL; break;   // read, print_char, print_num
+        case 0x27: arith(ARITH_RANDOM, 1); break;
+        case 0x28: in.op = LANE_PUSH; need = 1; break;
+        case 0x29: indirect(LANE_PULL, 1); break;
+        // 1OP
+        case 0x100: in.op = LANE_BRANCH; branch(TEST_JZ); need = 1; break;
+        case 0x101: case 0x102:                                        // get_sibling, get_child
+            in.op = LANE_STORE_ZERO; store(); branch(TEST_NEVER); break;
+        case 0x103: case 0x104: in.op = LANE_STORE_ZERO; store(); break;
+        case 0x105: indirect(LANE_INC, 1); break;
+        case 0x106: indirect(LANE_DEC, 1); break;
+        case 0x107: case 0x10A: case 0x10D: in.op = LANE_KERNEL; break;  // print_addr, print_obj, print_paddr
+        case 0x10B: in.op = LANE_RET; need = 1; break;
+        case 0x10C: in.op = LANE_JUMP; need = 1; break;
+        case 0x10E: indirect(LANE_LOAD, 1); store(); break;
+        case 0x10F: arith(ARITH_NOT, 1); break;
+        // 0OP
+        case 0x200: in.op = LANE_RET; in.ret = 1; break;
+        case 0x201: in.op = LANE_RET; in.ret = 0; break;
+        case 0x202: case 0x203: case 0x205: case 0x206: case 0x20B: case 0x20D:
+            in.op = LANE_KERNEL; break;                                 // output, ring ops, verify
+        default: break;                                                 // the kernel skips it
+    }
+    if (in.argc < need) in.op = LANE_KERNEL;
+    // An indirect variable must be a constant: the lanes do not read variables by number
+    if (in.op >= LANE_INC && in.op <= LANE_PULL && in.op != LANE_PUSH) {
+        if (in.type[0] == 2) in.op = LANE_KERNEL;
+        in.var = static_cast<zbyte>(in.value[0]);
+    }
+    in.next = static_cast<uint32_t>(p - lane_rom);
+    return in;
+}
+
+// Lane types: the same operand fetch and arithmetic over 8 sessions (AVX2) or 1
+struct Lanes8 {
+    static constexpr uint32_t width = 8;
+    __m256i v;
+};
+struct Lanes1 {
+    static constexpr uint32_t width = 1;
+    uint32_t v;
+};
+
+static inline Lanes8 splat(Lanes8, uint32_t x) { return {_mm256_set1_epi32(static_cast<int>(x))}; }
+static inline Lanes1 splat(Lanes1, uint32_t x) { return {x}; }
+static inline Lanes8 add(Lanes8 a, Lanes8 b) { return {_mm256_add_epi32(a.v, b.v)}; }
+static inline Lanes1 add(Lanes1 a, Lanes1 b) { return {a.v + b.v}; }
+static inline Lanes8 sub(Lanes8 a, Lanes8 b) { return {_mm256_sub_epi32(a.v, b.v)}; }
+static inline Lanes1 sub(Lanes1 a, Lanes1 b) { return {a.v - b.v}; }
+static inline Lanes8 mul(Lanes8 a, Lanes8 b) { return {_mm256_mullo_epi32(a.v, b.v)}; }
+static inline Lanes1 mul(Lanes1 a, Lanes1 b) { return {a.v * b.v}; }
+static inline Lanes8 band(Lanes8 a, Lanes8 b) { return {_mm256_and_si256(a.v, b.v)}; }
+static inline Lanes1 band(Lanes1 a, Lanes1 b) { return {a.v & b.v}; }
+static inline Lanes8 bor(Lanes8 a, Lanes8 b) { return {_mm256_or_si256(a.v, b.v)}; }
+static inline Lanes1 bor(Lanes1 a, Lanes1 b) { return {a.v | b.v}; }
+static inline Lanes8 bxor(Lanes8 a, Lanes8 b) { return {_mm256_xor_si256(a.v, b.v)}; }
+static inline Lanes1 bxor(Lanes1 a, Lanes1 b) { return {a.v ^ b.v}; }
+/** All ones where a == b. */
+static inline Lanes8 eq(Lanes8 a, Lanes8 b) { return {_mm256_cmpeq_epi32(a.v, b.v)}; }
+static inline Lanes1 eq(Lanes1 a, Lanes1 b) { return {a.v == b.v ? ~0u : 0u}; }
+/** All ones where a > b, as signed 32-bit. */
+static inline Lanes8 gt(Lanes8 a, Lanes8 b) { return {_mm256_cmpgt_epi32(a.v, b.v)}; }
+static inline Lanes1 gt(Lanes1 a, Lanes1 b) {
+    return {static_cast<int32_t>(a.v) > static_cast<int32_t>(b.v) ? ~0u : 0u};
+}
+/** The word, sign-extended (zargs cast to int16_t). */
+static inline Lanes8 sext(Lanes8 a) { return {_mm256_srai_epi32(_mm256_slli_epi32(a.v, 16), 16)}; }
+static inline Lanes1 sext(Lanes1 a) { return {static_cast<uint32_t>(static_cast<int16_t>(a.v))}; }
+/** Low 16 bits of a as a word. */
+template <class V> static inline V word(V a) { return band(a, splat(V{}, 0xFFFF)); }
+
+/** Register reg of the sessions at lanes[0, width). */
+static inline Lanes8 gather_reg(Lanes8, const std::vector<uint32_t>& reg, const uint32_t* lanes) {
+    __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+    return {_mm256_i32gather_epi32(reinterpret_cast<const int*>(reg.data()), idx, 4)};
+}
+static inline Lanes1 gather_reg(Lanes1, const std::vector<uint32_t>& reg, const uint32_t* lanes) {
+    return {reg[lanes[0]]};
+}
+
+/** The 4 bytes at each offset into base, where mask is set (0 elsewhere). */
+static inline Lanes8 gather_bytes(const uint8_t* base, Lanes8 offsets, Lanes8 mask) {
+    return {_mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(base),
+                                        offsets.v, mask.v, 1)};
+}
+static inline Lanes1 gather_bytes(const uint8_t* base, Lanes1 offset, Lanes1 mask) {
+    uint32_t v = 0;
+    if (mask.v) memcpy(&v, base + offset.v, 4);
+    return {v};
+}
+
+static inline Lanes8 shl8(Lanes8 a) { return {_mm256_slli_epi32(a.v, 8)}; }
+static inline Lanes1 shl8(Lanes1 a) { return {a.v << 8}; }
+static inline Lanes8 shr8(Lanes8 a) { return {_mm256_srli_epi32(a.v, 8)}; }
+static inline Lanes1 shr8(Lanes1 a) { return {a.v >> 8}; }
+
+/** Swap the low two bytes: a big-endian word as read little-endian. */
+template <class V> static inline V swap16(V a) {
+    V low = splat(V{}, 0xFF);
+    return bor(shl8(band(a, low)), band(shr8(a), low));
+}
+
+static inline uint32_t lane_get(Lanes8 a, uint32_t k) {
+    alignas(32) uint32_t out[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out), a.v);
+    return out[k];
+}
+static inline uint32_t lane_get(Lanes1 a, uint32_t) { return a.v; }
+
+template <class V> static inline void lanes_store(V a, uint32_t* out) {
+    for (uint32_t k = 0; k < V::width; k++) out[k] = lane_get(a, k);
+}
+static inline void lanes_store(Lanes8 a, uint32_t* out) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a.v);
+}
+
+/**
+ * read_variable() across the lanes: var 0 pops (sp is the lanes' stack pointer,
+ * updated), locals and globals are gathered from the state blocks.
+ */
+template <class V> static inline V fetch_var(zbyte var, V base, V locals, V& sp) {
+    V all = splat(V{}, ~0u);
+    if (var == 0) {
+        V has = gt(sp, splat(V{}, 0));
+        sp = add(sp, has);                         // has is -1 where sp > 0
+        V at = add(base, add(splat(V{}, ST_STACK), add(sp, sp)));
+        return band(word(gather_bytes(lane_states, at, all)), has);
+    }
+    if (var < 0x10) return word(gather_bytes(lane_states, add(locals, splat(V{}, var * 2u)), all));
+    V at = add(base, splat(V{}, DYN_OFFSET + lane_globals + (var - 0x10u) * 2));
+    return swap16(gather_bytes(lane_states, at, all));
+}
+
+/** load_operand() / decode_operand() for operand i. */
+template <class V> static inline V fetch(const LaneInsn& in, uint32_t i, V base, V locals, V& sp) {
+    if (in.type[i] != 2) return splat(V{}, in.value[i]);
+    return fetch_var(static_cast<zbyte>(in.value[i]), base, locals, sp);
+}
+
+/** read_word() (or read_byte()) at per-lane addresses below CODE_END, 0 past it. */
+template <class V> static inline V load_memory(V base, V addr, bool words) {
+    V in_dyn = gt(splat(V{}, lane_dyn - (words ? 1 : 0)), addr);
+    V in_rom = bxor(in_dyn, gt(splat(V{}, CODE_END), addr));
+    V raw = bor(gather_bytes(lane_states, add(base, add(splat(V{}, DYN_OFFSET), addr)), in_dyn),
+                gather_bytes(lane_rom, addr, in_rom));
+    return words ? swap16(raw) : band(raw, splat(V{}, 0xFF));
+}
+
+/**
+ * Run the group's instruction for the sessions at lanes[0, V::width): fetch
+ * and compute in lanes, then write back session by session. Sessions that must
+ * leave lockstep are left untouched, at this instruction.
+ */
+template <class V> static void run_lanes(const LaneInsn& in, const uint32_t* lanes, uint32_t step) {
+    V base = gather_reg(V{}, regs.base, lanes);
+    V locals = gather_reg(V{}, regs.locals, lanes);
+    V sp = gather_reg(V{}, regs.sp, lanes);
+    V args[8];
+    for (uint32_t i = 0; i < in.argc; i++) args[i] = fetch(in, i, base, locals, sp);
+
+    V a = in.argc > 0 ? args[0] : splat(V{}, 0);
+    V b = in.argc > 1 ? args[1] : splat(V{}, 0);
+    V result = splat(V{}, 0);
+    V cond = splat(V{}, 0);
+    V zero = splat(V{}, 0);
+    switch (in.op) {
+        case LANE_BRANCH:
+            switch (in.sub) {
+                case TEST_JE:
+                    for (uint32_t i = 1; i < in.argc; i++) cond = bor(cond, eq(a, args[i]));
+                    break;
+                case TEST_JL: cond = gt(sext(b), sext(a)); break;
+                case TEST_JG: cond = gt(sext(a), sext(b)); break;
+                case TEST_JZ: cond = eq(a, zero); break;
+                case TEST_BITS: cond = eq(band(a, b), b); break;
+                default: break;
+            }
+            break;
+        case LANE_ARITH:
+            switch (in.sub) {
+                case ARITH_ADD: result = word(add(a, b)); break;
+                case ARITH_SUB: result = word(sub(a, b)); break;
+                case ARITH_MUL: result = word(mul(a, b)); break;
+                case ARITH_AND: result = band(a, b); break;
+                case ARITH_OR: result = bor(a, b); break;
+                case ARITH_NOT: result = bxor(a, splat(V{}, 0xFFFF)); break;
+                case ARITH_RANDOM: result = band(gt(sext(a), zero), splat(V{}, 1)); break;
+                default: break;   // div, mod: per session below
+            }
+            break;
+        case LANE_INC: case LANE_DEC: case LANE_INC_CHK: case LANE_DEC_CHK: case LANE_LOAD: {
+            // The variable is read after the operands, as op_inc() and friends do
+            V value = fetch_var(in.var, base, locals, sp);
+            if (in.op == LANE_LOAD) {
+                result = value;
+            } else {
+                bool up = in.op == LANE_INC || in.op == LANE_INC_CHK;
+                result = word(up ? add(value, splat(V{}, 1)) : sub(value, splat(V{}, 1)));
+                if (in.op == LANE_INC_CHK) cond = gt(sext(result), sext(b));
+                if (in.op == LANE_DEC_CHK) cond = gt(sext(b), sext(result));
+            }
+            break;
+        }
+        case LANE_PULL:
+            result = fetch_var(0, base, locals, sp);
+            break;
+        case LANE_LOADW: result = load_memory(base, add(a, add(b, b)), true); break;
+        case LANE_LOADB: result = load_memory(base, add(a, b), false); break;
+        case LANE_JUMP: result = add(splat(V{}, in.next - 2), sext(a)); break;
+        default: break;
+    }
+
+    uint32_t sp_out[V::width], res[V::width], cnd[V::width], addr[V::width] = {};
+    uint32_t arg[8][V::width];
+    lanes_store(sp, sp_out);
+    lanes_store(result, res);
+    lanes_store(cond, cnd);
+    for (uint32_t i = 0; i < in.argc; i++) lanes_store(args[i], arg[i]);
+    if (in.op == LANE_STOREW || in.op == LANE_LOADW) lanes_store(add(a, add(b, b)), addr);
+    if (in.op == LANE_STOREB) lanes_store(add(a, b), addr);
+
+    for (uint32_t k = 0; k < V::width; k++) {
+        uint32_t lane = lanes[k];
+        uint32_t frame_sp = regs.frame_sp[lane];
+        bool taken = in.branches && ((cnd[k] != 0) == in.branch_on_true);
+        bool returns = in.op == LANE_RET || (taken && (in.offset == 0 || in.offset == 1));
+
+        // Leave lockstep, before any effect, where the kernel must run it
+        bool leave = false;
+        if (returns) leave = frame_sp <= 1;   // no_frame_locals is the kernel's, not the session's
+        if (in.op == LANE_CALL && arg[0][k] != 0 && arg[0][k] * 2 < CODE_END) {
+            leave = frame_sp >= 64 || arg[0][k] * 2 < lane_dyn;
+        }
+        if (in.op == LANE_STOREW) leave = addr[k] < CODE_END && addr[k] + 1 >= lane_dyn;
+        if (in.op == LANE_STOREB) leave = addr[k] < HOST_GAME_SIZE && addr[k] >= lane_dyn;
+        if (in.op == LANE_LOADW && addr[k] + 1 == lane_dyn) leave = true;
+        if (leave) {
+            regs.mode[lane] = MODE_LEFT;
+            regs.done[lane] = step;
+            continue;
+        }
+
+        regs.sp[lane] = sp_out[k];
+        regs.pc[lane] = in.next;
+        zword value = static_cast<zword>(res[k]);
+        switch (in.op) {
+            case LANE_ARITH:
+                if (in.sub == ARITH_DIV || in.sub == ARITH_MOD) {
+                    int16_t x = static_cast<int16_t>(arg[0][k]), y = static_cast<int16_t>(arg[1][k]);
+                    value = y == 0 ? 0 : static_cast<zword>(in.sub == ARITH_DIV ? x / y : x % y);
+                }
+                lane_write(lane, in.store, value);
+                break;
+            case LANE_STORE_ZERO: lane_write(lane, in.store, 0); break;
+            case LANE_LOADW: case LANE_LOADB: case LANE_LOAD: lane_write(lane, in.store, value); break;
+            case LANE_INC: case LANE_DEC: case LANE_INC_CHK: case LANE_DEC_CHK: case LANE_PULL:
+                lane_write(lane, in.var, value);
+                break;
+            case LANE_STORE: lane_write(lane, in.var, static_cast<zword>(arg[1][k])); break;
+            case LANE_PUSH: lane_write(lane, 0, static_cast<zword>(arg[0][k])); break;
+            case LANE_STOREW:
+                if (addr[k] < CODE_END) {
+                    uint8_t* m = lane_state(lane) + DYN_OFFSET + addr[k];
+                    m[0] = static_cast<uint8_t>(arg[2][k] >> 8);
+                    m[1] = static_cast<uint8_t>(arg[2][k]);
+                }
+                break;
+            case LANE_STOREB:
+                if (addr[k] < HOST_GAME_SIZE) lane_state(lane)[DYN_OFFSET + addr[k]] = static_cast<uint8_t>(arg[2][k]);
+                break;
+            case LANE_JUMP: regs.pc[lane] = res[k]; break;
+            case LANE_CALL: {
+                uint32_t call_args[8];
+                for (uint32_t i = 0; i < in.argc; i++) call_args[i] = arg[i][k];
+                lane_call(lane, in, call_args);
+                break;
+            }
+            case LANE_RET: lane_return(lane, in.argc ? static_cast<zword>(arg[0][k]) : in.ret); break;
+            default: break;
+        }
+        if (in.branches && taken) {
+            if (in.offset == 0 || in.offset == 1) {
+                lane_return(lane, static_cast<zword>(in.offset));
+            } else {
+                regs.pc[lane] = in.next + in.offset - 2;
+            }
+        }
+    }
+}
+
+/** Put back what the lanes wrote above the state's final sp / frame_sp. */
+static void lane_restore(uint32_t lane) {
+    LaneLog& log = regs.log[lane];
+    ZMachineState* state = lane_zstate(lane);
+    for (uint32_t i = log.stack_count; i-- > 0;) {
+        if (log.stack_index[i] >= state->sp) state->stack[log.stack_index[i]] = log.stack_old[i];
+    }
+    for (uint32_t i = 0; i < log.frame_count; i++) {
+        if (log.frame_slot[i] >= state->frame_sp) {
+            memcpy(&state->frames[log.frame_slot[i]], &log.frame_old[i], sizeof(Frame));
+        }
+    }
+}
+
+/** Whether the lanes can take this session's launch from its start. */
+static bool lane_can_start(const ZMachineState* state, const uint8_t* input) {
+    const HostCommand* host_cmd = reinterpret_cast<const HostCommand*>(input + HOST_CMD_OFFSET);
+    return state->instruction_count > 0 && host_cmd->op == HOST_CMD_NONE && !state->finished &&
+           (state->ring_stage == RING_NONE || state->ring_stage == RING_RAN) &&
+           state->frame_sp >= 1 && state->frame_sp <= 64 && state->sp <= 1024;
+}
+
+/** Fill lane_rom and the geometry from the loaded story; false if the lanes cannot run it. */
+static bool lane_load_story() {
+    if (lane_rom_story != rom) {
+        rom_copy(0, lane_rom, HOST_GAME_SIZE);
+        memset(lane_rom + HOST_GAME_SIZE, 0, sizeof(lane_rom) - HOST_GAME_SIZE);
+        lane_dyn = static_cast<uint32_t>(lane_rom[0x0E] << 8 | lane_rom[0x0F]);
+        lane_globals = static_cast<uint32_t>(lane_rom[0x0C] << 8 | lane_rom[0x0D]);
+        lane_rom_story = rom;
+    }
+    return rom && lane_dyn + DYN_OFFSET <= 32 * 1024 && lane_globals + NUM_GLOBALS * 2 <= lane_dyn;
+}
+
+extern "C" {
+
+uint32_t zork_lockstep_stats_size() { return sizeof(LockstepStats); }
+
+/**
+ * One launch of `sessions` sessions. inputs, states and outputs are consecutive
+ * blocks of SESSION_INPUT_SIZE, SESSION_STATE_SIZE and SESSION_OUTPUT_SIZE
+ * bytes; states are updated in place and each output block holds its text up
+ * to a NUL. With lanes false every session runs in kernel_main(), one at a
+ * time (the scalar host build on the same buffers). zork_host_load() first.
+ */
+bool zork_lockstep_launch(const uint8_t* inputs, uint8_t* states, uint8_t* outputs,
+                          uint32_t sessions, bool lanes, LockstepStats* stats) {
+    if (sessions > LOCKSTEP_MAX_SESSIONS || !rom) return false;
+    lanes = lanes && lane_load_story();
+    lane_states = states;
+    regs.pc.resize(sessions);
+    regs.sp.resize(sessions);
+    regs.frame_sp.resize(sessions);
+    regs.locals.resize(sessions);
+    regs.base.resize(sessions);
+    regs.done.resize(sessions);
+    regs.mode.resize(sessions);
+    regs.log.resize(sessions);
+
+    // Load the register file from the sessions that can start in lockstep
+    std::vector<uint64_t> active;
+    active.reserve(sessions);
+    for (uint32_t s = 0; s < sessions; s++) {
+        regs.base[s] = s * SESSION_STATE_SIZE;
+        ZMachineState* state = lane_zstate(s);
+        regs.done[s] = 0;
+        bool start = lanes && lane_can_start(state, inputs + size_t(s) * SESSION_INPUT_SIZE);
+        regs.mode[s] = start ? MODE_LOCKSTEP : MODE_KERNEL;
+        if (!start) continue;
+        if (state->ring_stage == RING_RAN) state->ring_stage = RING_NONE;
+        regs.pc[s] = state->pc_offset;
+        regs.sp[s] = state->sp;
+        lane_set_frame(s, state->frame_sp);
+        regs.log[s].stack_count = regs.log[s].frame_count = 0;
+        regs.log[s].frames_saved = 0;
+        active.push_back(s);
+    }
+
+    // Step: group by PC, decode once per group, run the group 8 sessions at a time
+    std::vector<uint32_t> group;
+    for (uint32_t step = 0; step < LOCKSTEP_SLICE && !active.empty(); step++) {
+        for (uint64_t& key : active) {
+            uint32_t s = static_cast<uint32_t>(key);
+            key = uint64_t(regs.pc[s]) << 32 | s;
+        }
+        std::sort(active.begin(), active.end());
+        size_t kept = 0;
+        for (size_t i = 0; i < active.size();) {
+            uint32_t pc = static_cast<uint32_t>(active[i] >> 32);
+            group.clear();
+            for (; i < active.size() && static_cast<uint32_t>(active[i] >> 32) == pc; i++) {
+                group.push_back(static_cast<uint32_t>(active[i]));
+            }
+            LaneInsn in = {};
+            in.op = LANE_KERNEL;
+            if (pc >= lane_dyn && pc + INSN_MAX <= CODE_END) in = lane_decode(pc);
+            stats->groups++;
+            if (in.op == LANE_KERNEL) {
+                for (uint32_t s : group) {
+                    regs.mode[s] = MODE_LEFT;
+                    regs.done[s] = step;
+                }
+                continue;
+            }
+            size_t wide = group.size() / 8 * 8;
+            for (size_t k = 0; k < wide; k += 8) run_lanes<Lanes8>(in, &group[k], step);
+            for (size_t k = wide; k < group.size(); k++) run_lanes<Lanes1>(in, &group[k], step);
+            for (size_t k = 0; k < group.size(); k++) {
+                uint32_t s = group[k];
+                if (regs.mode[s] != MODE_LOCKSTEP) continue;
+                active[kept++] = s;
+                regs.done[s] = step + 1;
+                (k < wide ? stats->lanes : stats->tails)++;
+            }
+        }
+        active.resize(kept);
+    }
+
+    // Write the registers back; the rest of each slice that left lockstep runs in the kernel
+    for (uint32_t s = 0; s < sessions; s++) {
+        ZMachineState* state = lane_zstate(s);
+        uint8_t* output = outputs + size_t(s) * SESSION_OUTPUT_SIZE;
+        bool stepped = regs.mode[s] != MODE_KERNEL;
+        if (stepped) {
+            state->pc_offset = regs.pc[s];
+            state->sp = regs.sp[s];
+            state->frame_sp = regs.frame_sp[s];
+            state->instruction_count += regs.done[s];
+        }
+        if (regs.mode[s] != MODE_LOCKSTEP) {
+            lockstep_slice = LOCKSTEP_SLICE - regs.done[s];
+            host_windows(inputs + size_t(s) * SESSION_INPUT_SIZE, lane_state(s), output);
+            kernel_main();
+            stats->kernel++;
+        } else {
+            output[0] = '\0';
+        }
+        if (stepped) lane_restore(s);
+    }
+    host_windows(host_dram + INPUT_DRAM_ADDR, host_dram + STATE_DRAM_ADDR, host_dram + OUTPUT_DRAM_ADDR);
+    stats->sessions += sessions;
+    return true;
+}
+
+}  // extern "C"
+
+#pragma GCC pop_options
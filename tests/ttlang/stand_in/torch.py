@@ -0,0 +1,56 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+Stand-in for the slice of torch that ttlang/zork_risc.py uses (see ttnn.py here).
+
+Tensors are flat byte buffers with a dtype: frombuffer / zeros / clone, and the
+.to(bfloat16).view(uint8).numpy() chain zork_risc uses to recover raw output bytes.
+"""
+from __future__ import annotations
+
+import struct
+
+uint8 = "uint8"
+float32 = "float32"
+bfloat16 = "bfloat16"
+
+ITEM_SIZE = {uint8: 1, float32: 4, bfloat16: 2}
+
+
+class Tensor:
+    def __init__(self, data: bytes | bytearray, dtype: str) -> None:
+        self.data = bytearray(data)
+        self.dtype = dtype
+
+    @property
+    def shape(self) -> tuple[int]:
+        return (len(self.data) // ITEM_SIZE[self.dtype],)
+
+    def clone(self) -> Tensor:
+        return Tensor(self.data, self.dtype)
+
+    def to(self, dtype: str) -> Tensor:
+        """float32 <-> bfloat16 keep the top 16 bits, as bfloat16 is defined."""
+        if dtype == self.dtype:
+            return self.clone()
+        if (self.dtype, dtype) == (float32, bfloat16):
+            words = struct.unpack(f"<{len(self.data) // 4}I", self.data)
+            return Tensor(struct.pack(f"<{len(words)}H", *(w >> 16 for w in words)), dtype)
+        if (self.dtype, dtype) == (bfloat16, float32):
+            halves = struct.unpack(f"<{len(self.data) // 2}H", self.data)
+            return Tensor(struct.pack(f"<{len(halves)}I", *(h << 16 for h in halves)), dtype)
+        raise NotImplementedError(f"stand-in torch: {self.dtype} -> {dtype}")
+
+    def view(self, dtype: str) -> Tensor:
+        return Tensor(self.data, dtype)
+
+    def numpy(self) -> memoryview:
+        return memoryview(bytes(self.data))
+
+
+def frombuffer(buffer: bytes | bytearray, dtype: str) -> Tensor:
+    return Tensor(buffer, dtype)
+
+
+def zeros(n: int, dtype: str) -> Tensor:
+    return Tensor(bytes(n * ITEM_SIZE[dtype]), dtype)
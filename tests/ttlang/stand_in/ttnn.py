@@ -0,0 +1,170 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+Stand-in for the slice of ttnn that ttlang/zork_risc.py uses, over the host build
+of the kernel (ttlang/zork_native.py). No hardware needed.
+
+Device tensors are byte buffers with a fake DRAM address. generic_op() reads the
+kernel's *_DRAM_ADDR defines back to their tensors, as the kernel would, and
+runs one zork_native launch over them: the state tensor (plus the ring tensor,
+when RING_DRAM_ADDR is defined) goes in as each session's STATE_SIZE state
+bytes, and the states and output text come back into the tensors.
+
+allocate_tensor_on_device() fills the buffer with GARBAGE, so a launch that
+reads bytes the host never wrote shows up in the results. `stats` counts device
+opens, allocations, launches, and the bytes copied each way.
+"""
+from __future__ import annotations
+
+import itertools
+from collections import Counter
+
+import torch
+
+uint8 = torch.uint8
+bfloat16 = torch.bfloat16
+ROW_MAJOR_LAYOUT = "ROW_MAJOR"
+DRAM_MEMORY_CONFIG = "DRAM"
+GARBAGE = 0xA5
+
+stats: Counter = Counter()
+
+_addresses = itertools.count(0x100000, 0x100000)
+_tensors: dict[int, Tensor] = {}
+
+
+class Device:
+    def __init__(self, device_id: int) -> None:
+        self.device_id = device_id
+        self.open = True
+
+
+class Shape(tuple):
+    pass
+
+
+class Tensor:
+    def __init__(self, data: bytes | bytearray, dtype: str, device: Device | None) -> None:
+        self._data = bytearray(data)
+        self.dtype = dtype
+        self.device = device
+        if device is not None:
+            self._address = next(_addresses)
+            _tensors[self._address] = self
+            stats["allocations"] += 1
+
+    @property
+    def data(self) -> bytearray:
+        if self.device is not None and not self.device.open:
+            raise RuntimeError("stand-in ttnn: tensor used after close_device()")
+        return self._data
+
+    @property
+    def shape(self) -> Shape:
+        return Shape([len(self._data) // torch.ITEM_SIZE[self.dtype]])
+
+    def buffer_address(self) -> int:
+        self.data
+        return self._address
+
+
+def open_device(device_id: int = 0) -> Device:
+    stats["opens"] += 1
+    return Device(device_id)
+
+
+def close_device(device: Device) -> None:
+    device.open = False
+
+
+def from_torch(t: torch.Tensor, dtype: str = uint8, layout: str = ROW_MAJOR_LAYOUT,
+               device: Device | None = None, memory_config: str | None = None) -> Tensor:
+    raw = t.to(dtype).data if t.dtype != dtype else t.data
+    if device is not None:
+        stats["to_device"] += len(raw)
+    return Tensor(raw, dtype, device)
+
+
+def allocate_tensor_on_device(shape: Shape, dtype: str, layout: str, device: Device,
+                              memory_config: str | None = None) -> Tensor:
+    (n,) = shape
+    return Tensor(bytes([GARBAGE]) * (n * torch.ITEM_SIZE[dtype]), dtype, device)
+
+
+def copy_host_to_device_tensor(host: Tensor, device_tensor: Tensor) -> None:
+    if len(host.data) != len(device_tensor.data):
+        raise ValueError("stand-in ttnn: copy_host_to_device_tensor size mismatch")
+    device_tensor.data[:] = host.data
+    stats["to_device"] += len(host.data)
+
+
+def to_torch(t: Tensor) -> torch.Tensor:
+    stats["from_device"] += len(t.data)
+    host = torch.Tensor(t.data, t.dtype)
+    return host.to(torch.float32) if t.dtype == bfloat16 else host
+
+
+class CoreCoord:
+    def __init__(self, x: int, y: int) -> None:
+        self.x, self.y = x, y
+
+
+class CoreRange:
+    def __init__(self, start: CoreCoord, end: CoreCoord) -> None:
+        self.start, self.end = start, end
+
+
+class CoreRangeSet:
+    def __init__(self, ranges: list[CoreRange]) -> None:
+        self.ranges = ranges
+
+
+class ReaderConfigDescriptor:
+    pass
+
+
+class KernelDescriptor:
+    class SourceType:
+        FILE_PATH = "FILE_PATH"
+
+    def __init__(self, **fields) -> None:
+        self.__dict__.update(fields)
+
+
+class ProgramDescriptor:
+    def __init__(self, **fields) -> None:
+        self.__dict__.update(fields)
+
+
+def generic_op(tensors: list[Tensor], program: ProgramDescriptor) -> None:
+    """One launch of the host kernel over the buffers the defines point at."""
+    from ttlang import zork_native
+    from ttlang.zork_risc import INPUT_SIZE, OUTPUT_SIZE, STATE_SIZE, UNDO_RING_OFFSET
+
+    (kernel,) = program.kernels
+    defines = {name: value for name, value in kernel.defines}
+    sessions = int(defines.get("ZORK_SESSIONS", "1"))
+    buffer = {name: _tensors[int(defines[name], 16)] for name in defines if name.endswith("_DRAM_ADDR")}
+    if not all(t in tensors for t in buffer.values()):
+        raise ValueError("stand-in ttnn: a *_DRAM_ADDR buffer is not among the op's tensors")
+    stats["launches"] += 1
+
+    state_t, ring_t = buffer["STATE_DRAM_ADDR"], buffer.get("RING_DRAM_ADDR")
+    size = UNDO_RING_OFFSET if ring_t else STATE_SIZE
+    ring_size = STATE_SIZE - UNDO_RING_OFFSET
+    states = [bytes(state_t.data[i * size:(i + 1) * size]) +
+              (bytes(ring_t.data[i * ring_size:(i + 1) * ring_size]) if ring_t else b"")
+              for i in range(sessions)]
+    inputs = [bytes(buffer["INPUT_DRAM_ADDR"].data[i * INPUT_SIZE:(i + 1) * INPUT_SIZE])
+              for i in range(sessions)]
+
+    texts, states = zork_native.kernel(sessions).launch(bytes(buffer["GAME_DRAM_ADDR"].data), inputs, states)
+
+    for i, state in enumerate(states):
+        state_t.data[i * size:(i + 1) * size] = state[:size]
+        if ring_t:
+            ring_t.data[i * ring_size:(i + 1) * ring_size] = state[size:]
+    output = buffer["OUTPUT_DRAM_ADDR"].data
+    for i, text in enumerate(texts):
+        raw = text.encode("ascii", errors="replace") + b"\0"
+        output[i * OUTPUT_SIZE:i * OUTPUT_SIZE + len(raw)] = raw
@@ -0,0 +1,116 @@
+# tests/ttlang/test_async.py
+# Coroutine sessions coalesced into shared launches (host backend, no hardware).
+import asyncio
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang.zork_async import SessionLoop
+from ttlang.zork_server import HostBackend
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+
+class _CountingBackend:
+    width = 4
+
+    def __init__(self):
+        self.batches = []
+
+    def new_state(self):
+        return ()
+
+    def run_many(self, states, commands):
+        self.batches.append(len(commands))
+        return [f"{len(s)}:{c}" for s, c in zip(states, commands)], [s + (c,) for s, c in zip(states, commands)]
+
+
+def test_concurrent_steps_share_launches():
+    backend = _CountingBackend()
+
+    async def main():
+        async with SessionLoop(backend) as loop:
+            sessions = [await loop.open() for _ in range(10)]
+            backend.batches.clear()
+            replies = await asyncio.gather(*(s.step("look") for s in sessions))
+            return replies, loop.metrics()
+
+    replies, metrics = asyncio.run(main())
+    assert replies == ["1:look"] * 10
+    assert backend.batches == [4, 4, 2]
+    assert metrics["sessions"] == 10 and metrics["queue_depth"] == 0
+
+
+def test_one_sessions_steps_stay_in_order():
+    backend = _CountingBackend()
+
+    async def main():
+        async with SessionLoop(backend) as loop:
+            s = loop.attach(())
+            return await asyncio.gather(s.step("a"), s.step("b"), s.step("c")), s.state
+
+    replies, state = asyncio.run(main())
+    assert replies == ["0:a", "1:b", "2:c"]
+    assert state == ("a", "b", "c")
+    assert backend.batches == [1, 1, 1]       # one step per session per launch
+
+
+def test_closed_session_cannot_step():
+    async def main():
+        async with SessionLoop(_CountingBackend()) as loop:
+            s = await loop.open()
+            s.close()
+            with pytest.raises(KeyError):
+                await s.step("look")
+
+    asyncio.run(main())
+
+
+def test_host_games_play_concurrently():
+    async def main():
+        async with SessionLoop(HostBackend(GAME_FILE)) as loop:
+            sessions = await asyncio.gather(*(loop.open() for _ in range(4)))
+            replies = await asyncio.gather(*(s.step("open mailbox") for s in sessions))
+            return sessions, replies, loop.launches
+
+    sessions, replies, launches = asyncio.run(main())
+    assert all("ZORK I" in s.opening for s in sessions)
+    assert all("leaflet" in r.lower() for r in replies)
+    assert launches == 2
+
+
+def test_snapshot_and_replace_wait_for_the_launch():
+    import time
+
+    class _SlowBackend(_CountingBackend):
+        def new_state(self):
+            return []
+
+        def run_many(self, states, commands):
+            for s, c in zip(states, commands):   # mutates in place, like HostBackend
+                s.append(c)
+                time.sleep(0.05)
+                s.append(c)
+            return list(commands), states
+
+        def snapshot(self, state):
+            return repr(state).encode()
+
+    async def main():
+        async with SessionLoop(_SlowBackend()) as loop:
+            s = loop.attach([])
+            step = asyncio.ensure_future(s.step("look"))
+            await asyncio.sleep(0.01)              # the launch is on the executor
+            image = await s.snapshot()
+            await step
+            await loop.replace(s.id, ["restored"])
+            with pytest.raises(KeyError):
+                await loop.replace(s.id + 1, [])   # never issued
+            return image, s.state, loop.attach([]).id
+
+    image, state, new_id = asyncio.run(main())
+    assert image == b"['look', 'look']"
+    assert state == ["restored"]
+    assert new_id == 2
@@ -0,0 +1,60 @@
+# tests/ttlang/test_dedup.py
+# Deduplicated runs of kernel sessions (fake runner; host kernel when a compiler exists).
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native
+from ttlang.zork_dedup import MAX_SESSIONS, native_runner, run_deduped
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+
+def _fake_run(calls):
+    def run(commands, states):
+        assert len(commands) <= MAX_SESSIONS
+        calls.append(list(commands))
+        return ([f"{s!r}:{c}" for s, c in zip(states, commands)],
+                [(s or b"") + c.encode() + b";" for s, c in zip(states, commands)])
+    return run
+
+
+def test_identical_sessions_share_one_run():
+    calls = []
+    commands = ["north"] * 10 + ["south"] * 5 + ["north"]
+    texts, states, stats = run_deduped(_fake_run(calls), commands)
+    assert calls == [["north", "south"]]
+    assert texts == ["None:north"] * 10 + ["None:south"] * 5 + ["None:north"]
+    assert states[0] is states[15]          # the group shares the result
+    assert (stats.sessions, stats.groups, stats.calls) == (16, 2, 1)
+    assert stats.fan_out == 8.0
+
+
+def test_diverging_sessions_run_on_their_own():
+    calls = []
+    states = [b"a", b"a", b"b", None, b"a"]
+    commands = ["look", "look", "look", "look", "east"]
+    texts, out, stats = run_deduped(_fake_run(calls), commands, states)
+    assert stats.groups == 4 and stats.calls == 1
+    assert out == [b"alook;", b"alook;", b"blook;", b"look;", b"aeast;"]
+
+
+def test_groups_are_packed_max_sessions_per_call():
+    calls = []
+    commands = [f"cmd{i % 9}" for i in range(90)]
+    _, _, stats = run_deduped(_fake_run(calls), commands)
+    assert stats.groups == 9
+    assert [len(c) for c in calls] == [4, 4, 1]
+
+
+@pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+def test_dedup_matches_one_run_per_session(tmp_path, monkeypatch):
+    monkeypatch.setenv("ZORK_NATIVE_CACHE", str(tmp_path))
+    run = native_runner(GAME_FILE, num_batches=40)
+    commands = ["open mailbox", "north", "open mailbox", "take all", "north", "open mailbox"]
+    texts, states, stats = run_deduped(run, commands)
+    assert stats.groups == 3
+    for command, text, state in zip(commands, texts, states):
+        assert run([command], [None]) == ([text], [state])
@@ -0,0 +1,65 @@
+# tests/ttlang/test_explore.py
+# Explorer dedup and room graph over a fake runner — no hardware or ttnn needed.
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+from ttlang.zork_explore import Explorer
+from ttlang.zork_state import (
+    STATE_DYN_OFFSET, STATE_INSTRUCTION_COUNT_OFFSET, current_room, dynamic_size, state_hash,
+)
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+STORY = GAME_FILE.read_bytes()
+GLOBALS = int.from_bytes(STORY[0x0C:0x0E], "big")
+
+# A three-room corridor: north moves up it, south moves back, the ends are walls.
+ROOMS = (10, 20, 30)
+
+
+def _state(room: int, turn: int = 1) -> bytes:
+    state = bytearray(STATE_DYN_OFFSET) + bytearray(STORY[:dynamic_size(STORY)])
+    state[STATE_INSTRUCTION_COUNT_OFFSET] = turn  # bookkeeping — must not affect the hash
+    state[STATE_DYN_OFFSET + GLOBALS:STATE_DYN_OFFSET + GLOBALS + 2] = room.to_bytes(2, "big")
+    return bytes(state)
+
+
+def _corridor(calls):
+    def run_many(states, commands):
+        calls.append(len(commands))
+        out = []
+        for state, command in zip(states, commands):
+            i = ROOMS.index(current_room(state, STORY))
+            i = min(i + 1, 2) if command == "north" else max(i - 1, 0)
+            out.append(_state(ROOMS[i], turn=len(calls) + 1))
+        return [""] * len(out), out
+    return run_many
+
+
+def test_state_hash_ignores_host_bookkeeping():
+    assert state_hash(_state(10, turn=1), STORY) == state_hash(_state(10, turn=7), STORY)
+    assert state_hash(_state(10), STORY) != state_hash(_state(20), STORY)
+
+
+def test_explorer_dedups_states_and_builds_room_graph():
+    calls = []
+    explorer = Explorer(GAME_FILE, commands=("north", "south"),
+                        run_many=_corridor(calls), width=3)
+    graph = explorer.explore(_state(10), max_depth=5)
+
+    assert len(graph.nodes) == 3                 # one node per room despite 5 levels
+    assert {n.room for n in graph.nodes.values()} == set(ROOMS)
+    assert graph.room_graph() == {
+        (10, 20): {"north"}, (20, 30): {"north"},
+        (20, 10): {"south"}, (30, 20): {"south"},
+    }
+    assert graph.expanded == 6                   # each unique state expanded once
+    assert max(calls) <= 3
+
+
+def test_explorer_stops_at_max_depth():
+    explorer = Explorer(GAME_FILE, commands=("north", "south"),
+                        run_many=_corridor([]), width=4)
+    graph = explorer.explore(_state(10), max_depth=1)
+    assert max(n.depth for n in graph.nodes.values()) == 1
+    assert graph.expanded == 2
@@ -0,0 +1,70 @@
+# tests/ttlang/test_fuzz.py
+# Snapshot-reset fuzz target over the host kernel (needs a C++ compiler, no hardware).
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native, zork_state
+from ttlang.zork_fuzz import CORRUPTING, FuzzCase, FuzzReport, FuzzTarget, fuzz
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+pytestmark = pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+
+
+@pytest.fixture(scope="module")
+def target(tmp_path_factory):
+    mp = pytest.MonkeyPatch()
+    mp.setenv("ZORK_NATIVE_CACHE", str(tmp_path_factory.mktemp("native")))
+    t = FuzzTarget(GAME_FILE)
+    t.snapshot()
+    yield t
+    mp.undo()
+
+
+def test_snapshot_sits_on_the_first_read(target):
+    state = target.state()
+    pc = int.from_bytes(state[:4], "little")
+    assert GAME_FILE.read_bytes()[pc] == 0xE4      # sread
+
+
+def test_a_case_runs_like_kernel_launches_from_the_snapshot(target):
+    text, kind = target.replay(FuzzCase.of("open mailbox"), 200)
+    assert kind == "ok" and "open mailbox" in text
+
+    k = zork_native.kernel(1)
+    story = zork_native.map_story(GAME_FILE)
+    block = [zork_state.input_block("open mailbox", None)]
+    state, launched = target.state(), []
+    for _ in range(200 // zork_native.SLICE):
+        texts, (state,) = k.launch(story, block, [state])
+        launched.append(texts[0])
+    assert text == "".join(launched)
+
+
+def test_cases_leave_the_snapshot_as_they_found_it(target):
+    before = target.replay(FuzzCase.of("take leaflet"), 500)
+    report = FuzzReport()
+    target.run(report, 5000, "input", budget=500, seed=7)
+    assert report.cases == 5000 and report.restored > 0
+    assert target.replay(FuzzCase.of("take leaflet"), 500) == before
+
+
+def test_a_run_stops_at_the_first_case_that_may_corrupt_the_process(target):
+    report = FuzzReport()
+    target.run(report, 2000, "bytecode", budget=500, seed=3)
+    assert sum(report.findings[k] for k in CORRUPTING) == 1
+    assert report.cases < 2000
+    assert report.found[report.kept - 1].kind in CORRUPTING
+
+
+def test_fuzz_reports_throughput_and_survives_bytecode_faults(target):
+    result = fuzz(target, "input", cases=3000, chunk=1000)
+    assert result.cases == 3000 and result.execs_per_second > 0
+    assert not result.crashes
+
+    result = fuzz(target, "bytecode", cases=2000, chunk=500, seed=3)
+    assert result.cases >= 2000
+    assert result.findings                          # mutated code faults or runs off
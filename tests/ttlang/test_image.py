@@ -0,0 +1,110 @@
+# tests/ttlang/test_image.py
+# Session image export/import round trip and validation.
+import random
+import struct
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native, zork_state
+from ttlang.zork_image import ImageError, export_image, import_image, move_session
+from ttlang.zork_state import (
+    RING_TAKEN, STATE_DYN_OFFSET, STATE_FRAME_SP_OFFSET, STATE_FRAMES_OFFSET,
+    STATE_RING_OFFSET, STATE_RING_STAGE_OFFSET, STATE_SIZE, STATE_SP_OFFSET,
+    STATE_STRUCT_SIZE, STATE_UNDO_HEAD_OFFSET, dynamic_memory, dynamic_size, vm_bytes,
+)
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+STORY = GAME_FILE.read_bytes()
+
+
+def _state(seed: int = 1) -> bytes:
+    """A plausible mid-game state: live stack and frames, dirty dynamic memory."""
+    rng = random.Random(seed)
+    state = bytearray(rng.randbytes(STATE_SIZE))  # garbage everywhere, like the kernel's padding
+    struct.pack_into("<I", state, 0, 0x4F05)
+    struct.pack_into("<I", state, STATE_SP_OFFSET, 7)
+    struct.pack_into("<I", state, STATE_FRAME_SP_OFFSET, 3)
+    dyn = bytearray(STORY[:dynamic_size(STORY)])
+    dyn[0x2000] ^= 0x55
+    state[STATE_DYN_OFFSET:STATE_DYN_OFFSET + len(dyn)] = dyn
+    state[STATE_RING_OFFSET:] = bytes(STATE_SIZE - STATE_RING_OFFSET)
+    state[STATE_RING_OFFSET + 100] = 9
+    struct.pack_into("<I", state, STATE_RING_STAGE_OFFSET, RING_TAKEN)
+    return bytes(state)
+
+
+def test_round_trip_preserves_the_session():
+    state = _state()
+    image = export_image(state, STORY, output_cursor=42, pending_input=["north", "take lamp"])
+    back = import_image(image, STORY)
+
+    assert vm_bytes(back.state) == vm_bytes(state)
+    assert dynamic_memory(back.state, STORY) == dynamic_memory(state, STORY)
+    assert back.state[STATE_UNDO_HEAD_OFFSET:STATE_STRUCT_SIZE] == \
+        state[STATE_UNDO_HEAD_OFFSET:STATE_STRUCT_SIZE]
+    assert back.state[STATE_RING_STAGE_OFFSET:STATE_RING_STAGE_OFFSET + 4] == \
+        struct.pack("<I", RING_TAKEN)
+    assert back.state[STATE_RING_OFFSET:] == state[STATE_RING_OFFSET:]
+    assert back.output_cursor == 42
+    assert back.pending_input == ["north", "take lamp"]
+    assert len(image) < STATE_SIZE // 4
+
+
+def test_import_rejects_other_stories_and_newer_versions():
+    image = export_image(_state(), STORY)
+    other = bytearray(STORY)
+    other[0x12:0x18] = b"999999"
+    with pytest.raises(ImageError):
+        import_image(image, bytes(other))
+    newer = image[:4] + struct.pack("<H", 99) + image[6:]
+    with pytest.raises(ImageError):
+        import_image(newer, STORY)
+
+
+def test_version_1_images_import_with_no_ring_stage():
+    state = _state()
+    image = export_image(state, STORY)
+    # A version 1 image is the same without the ring_stage word after verify_*
+    at = image.index(state[STATE_UNDO_HEAD_OFFSET:STATE_RING_STAGE_OFFSET]) + \
+        STATE_RING_STAGE_OFFSET - STATE_UNDO_HEAD_OFFSET
+    v1 = image[:4] + struct.pack("<H", 1) + image[6:at] + image[at + 4:]
+    back = import_image(v1, STORY).state
+    assert back[STATE_RING_STAGE_OFFSET:STATE_RING_STAGE_OFFSET + 4] == bytes(4)
+    assert back[:STATE_RING_STAGE_OFFSET] == import_image(image, STORY).state[:STATE_RING_STAGE_OFFSET]
+    assert back[STATE_DYN_OFFSET:] == import_image(image, STORY).state[STATE_DYN_OFFSET:]
+
+
+@pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+def test_session_moved_mid_ring_launch_runs_on_identically(tmp_path, monkeypatch):
+    monkeypatch.setenv("ZORK_NATIVE_CACHE", str(tmp_path))
+    k = zork_native.kernel(1)
+    block = zork_state.input_block("open mailbox", None)
+    state = None
+    for _ in range(1000):
+        _, (state,) = k.launch(STORY, [block], [state])
+        if struct.unpack_from("<I", state, STATE_RING_STAGE_OFFSET)[0] == RING_TAKEN:
+            break
+    else:
+        pytest.fail("no READ snapshot launch")
+
+    moved = import_image(export_image(state, STORY), STORY).state
+    for _ in range(3):
+        _, (state,) = k.launch(STORY, [block], [state])
+        _, (moved,) = k.launch(STORY, [block], [moved])
+    assert vm_bytes(moved) == vm_bytes(state)
+    assert moved[STATE_UNDO_HEAD_OFFSET:STATE_STRUCT_SIZE] == state[STATE_UNDO_HEAD_OFFSET:STATE_STRUCT_SIZE]
+    assert dynamic_memory(moved, STORY) == dynamic_memory(state, STORY)
+    assert moved[STATE_RING_OFFSET:] == state[STATE_RING_OFFSET:]
+
+
+def test_move_session_takes_first_free_slot():
+    src = [_state(1), _state(2)]
+    dst = [_state(3), None]
+    assert move_session(src, 1, dst, STORY) == 1
+    assert src[1] is None
+    assert vm_bytes(dst[1]) == vm_bytes(_state(2))
+    assert dst[1][STATE_FRAMES_OFFSET:STATE_FRAMES_OFFSET + 5] == \
+        _state(2)[STATE_FRAMES_OFFSET:STATE_FRAMES_OFFSET + 5]
@@ -0,0 +1,45 @@
+# tests/ttlang/test_load.py
+# Load generator against an embedded host-backend server (no hardware).
+import json
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native
+from ttlang.zork_load import embedded_server, load_transcript, percentiles, run_load
+
+REPO = Path(__file__).parent.parent.parent
+GAME_FILE = REPO / "game" / "zork1.z3"
+
+
+def test_demo_script_becomes_a_command_stream():
+    stream = load_transcript(REPO / "demos" / "demo-stage1.sh")
+    assert [c for _, c in stream] == ["look", "open mailbox", "take leaflet", "read leaflet"]
+    assert [t for t, _ in stream] == [4, 3, 3, 3]
+
+
+def test_percentiles():
+    p = percentiles([i / 1000 for i in range(1, 101)])
+    assert p["p50"] == 51.0 and p["p99"] == 100.0 and p["max"] == 100.0 and p["n"] == 100
+
+
+@pytest.mark.parametrize("backend", ["host", "python"])
+def test_closed_loop_run_reports_latency_and_batching(tmp_path, monkeypatch, backend):
+    if backend == "host" and not zork_native.available():
+        pytest.skip("no C++ compiler")
+    monkeypatch.setenv("ZORK_NATIVE_CACHE", str(tmp_path / "native"))
+    stream = [(0.0, "open mailbox"), (0.0, "north")]
+    with embedded_server(GAME_FILE, backend, str(tmp_path / "z.sock")) as sock:
+        report = run_load(sock, players=4, stream=stream, rounds=2)
+    summary = report.summary()
+    assert summary["errors"] == 0
+    assert summary["commands"] == 4 * (1 + 2 * len(stream))
+    north = summary["per_command"]["north"]
+    assert north["n"] == 8
+    assert 1 <= north["mean_batch"] <= north["max_batch"] <= 4
+    assert 0 < summary["launches_per_command"] <= 1
+    report.write_csv(tmp_path / "load.csv")
+    assert (tmp_path / "load.csv").read_text().startswith("command,n,p50_ms")
+    json.dumps(summary)
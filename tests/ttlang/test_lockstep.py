@@ -0,0 +1,81 @@
+# tests/ttlang/test_lockstep.py
+# The SIMD lockstep host build (kernels/zork_lockstep.cpp) against one
+# zork_native launch per session.
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_lockstep, zork_native
+from ttlang.zork_state import input_block
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+COMMANDS = ["open mailbox", "north", "look", "take all", "inventory", "east", "", "read leaflet", "west"]
+
+pytestmark = pytest.mark.skipif(not zork_lockstep.available(), reason="no C++ compiler or no AVX2")
+
+
+@pytest.fixture(autouse=True, scope="module")
+def _cache(tmp_path_factory):
+    mp = pytest.MonkeyPatch()
+    mp.setenv("ZORK_NATIVE_CACHE", str(tmp_path_factory.mktemp("native")))
+    yield
+    mp.undo()
+
+
+@pytest.fixture(scope="module")
+def opening():
+    return zork_native.run_session(GAME_FILE, num_batches=300)[1]
+
+
+def _native(commands, states, num_batches):
+    """zork_native, one single-session launch per session."""
+    texts, finals = [], []
+    for command, state in zip(commands, states):
+        (text,), (final,) = zork_native.run_sessions(GAME_FILE, [command], [state], num_batches, headless=True)
+        texts.append(text)
+        finals.append(final)
+    return texts, finals
+
+
+@pytest.mark.parametrize("lanes", [True, False])
+def test_sessions_match_native_from_fresh_and_mid_game(opening, lanes):
+    commands = (COMMANDS * 3)[:20]
+    states = [None if i % 5 == 0 else opening for i in range(len(commands))]
+    k = zork_lockstep.kernel(len(commands))
+    k.stats = zork_lockstep.LockstepStats()
+    lockstep = zork_lockstep.run_sessions(GAME_FILE, commands, states, num_batches=250, headless=True, lanes=lanes)
+    assert lockstep == _native(commands, states, 250)
+    assert k.stats.sessions == 250 * len(commands)
+    if lanes:
+        # 16 sessions share the opening state: most of their instructions go 8 at a time,
+        # the 4 fresh ones (and the sessions that branch apart) one at a time
+        assert k.stats.lanes > k.stats.sessions * zork_native.SLICE // 2
+        assert k.stats.tails > 0
+    else:
+        assert k.stats.lanes == k.stats.tails == 0 and k.stats.kernel == k.stats.sessions
+
+
+def test_resident_states_continue_across_calls(opening):
+    commands = ["north", "look"] * 4 + ["open mailbox"]
+    k = zork_lockstep.kernel(len(commands))
+    story = zork_native.map_story(GAME_FILE)
+    k.load([opening] * len(commands))
+    k.set_inputs([input_block(c, None, True) for c in commands])
+    texts = [[] for _ in commands]
+    for _ in range(150):
+        for i, text in enumerate(k.launch(story)):
+            if text.strip():
+                texts[i].append(text)
+    native_texts, native_states = _native(commands, [opening] * len(commands), 150)
+    assert ["\n".join(t) for t in texts] == native_texts
+    assert k.states() == native_states
+
+
+def test_more_sessions_than_the_host_build():
+    commands = ["look"] * 12
+    texts, states = zork_lockstep.run_sessions(GAME_FILE, commands, num_batches=40, headless=True)
+    assert len(texts) == len(states) == 12 > zork_native.MAX_SESSIONS
+    assert len(set(states)) == 1 and texts[0].strip()
+    assert (texts[0], states[0]) == tuple(x[0] for x in _native(["look"], [None], 40))
@@ -0,0 +1,86 @@
+# tests/ttlang/test_native.py
+# The RISC-V kernel built for the host (needs a C++ compiler, no hardware).
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native, zork_state
+from ttlang.zork_state import STATE_INSTRUCTION_COUNT_OFFSET, is_fresh, print_events, state_hash
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+pytestmark = pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+
+
+@pytest.fixture(autouse=True, scope="module")
+def _cache(tmp_path_factory):
+    mp = pytest.MonkeyPatch()
+    mp.setenv("ZORK_NATIVE_CACHE", str(tmp_path_factory.mktemp("native")))
+    yield
+    mp.undo()
+
+
+def _count(state: bytes) -> int:
+    return int.from_bytes(state[STATE_INSTRUCTION_COUNT_OFFSET:STATE_INSTRUCTION_COUNT_OFFSET + 4], "little")
+
+
+def test_native_session_prints_the_opening():
+    text, state = zork_native.run_session(GAME_FILE, num_batches=30)
+    assert text.startswith("ZORK I: The Great Underground Empire")
+    assert not is_fresh(state)
+    assert _count(state) % zork_native.SLICE == 0
+
+
+def test_time_sliced_sessions_match_single_sessions():
+    commands = ["open mailbox", "north", "take all"]
+    texts, states = zork_native.run_sessions(GAME_FILE, commands, num_batches=40)
+    for command, text, state in zip(commands, texts, states):
+        (one_text,), (one_state,) = zork_native.run_sessions(GAME_FILE, [command], num_batches=40)
+        assert (text, state) == (one_text, one_state)
+
+
+def test_machine_snapshot_resumes_identically():
+    story = GAME_FILE.read_bytes()
+    zm = zork_native.NativeZMachine(story)
+    zm.input_command = "open mailbox"
+    zm.interpret(300)
+    snap = zm.snapshot()
+    zm.flush_output()
+    zm.interpret(200)
+    expected = zm.flush_output()
+
+    other = zork_native.NativeZMachine(story)
+    other.input_command = "open mailbox"
+    other.restore(snap)
+    other.interpret(200)
+    assert other.flush_output() == expected
+    assert other.instruction_count == zm.instruction_count == 500
+    assert other.running and not other.game_over
+
+
+def test_mapped_story_runs_like_a_copied_one():
+    story = zork_native.map_story(GAME_FILE)
+    assert zork_native.map_story(str(GAME_FILE)) is story
+    assert story.read() == GAME_FILE.read_bytes()
+    k = zork_native.kernel(1)
+    block = [zork_state.input_block("open mailbox", None)]
+    mapped, copied = [None], [None]
+    for _ in range(60):   # alternating remaps L1 between the two each launch
+        texts, mapped = k.launch(story, block, mapped)
+        texts_copy, copied = k.launch(story.read(), block, copied)
+        assert (texts, mapped) == (texts_copy, copied)
+
+
+def test_headless_sessions_reach_the_same_states():
+    story = GAME_FILE.read_bytes()
+    commands = ["open mailbox", "north"]
+    texts, states = zork_native.run_sessions(GAME_FILE, commands, num_batches=300)
+    events, quiet = zork_native.run_sessions(GAME_FILE, commands, num_batches=300, headless=True)
+    for text, state, record, quiet_state in zip(texts, states, events, quiet):
+        assert state_hash(quiet_state, story) == state_hash(state, story)
+        assert "ZORK" in text and "ZORK" not in record
+        kinds = [kind for kind, _ in print_events(record)]
+        assert kinds[0] == "s" and "r" in kinds
+        assert len(record.replace("\n", "")) == 6 * len(kinds)
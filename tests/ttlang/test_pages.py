@@ -0,0 +1,46 @@
+# tests/ttlang/test_pages.py
+# Page store round trip, sharing and reference counting.
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+from ttlang.zork_pages import PAGE_SIZE, PageStore
+
+STATE_SIZE = 96 * 1024
+
+
+def _state(seed: int) -> bytes:
+    state = bytearray(STATE_SIZE)
+    state[:16 * 1024] = bytes(range(256)) * 64     # shared "dynamic memory"
+    state[100 * seed % 16384] = seed & 0xFF        # one byte that differs
+    return bytes(state)
+
+
+def test_round_trip_reassembles_the_state_layout():
+    store = PageStore()
+    state = _state(3)
+    ref = store.put(state)
+    assert store.get(ref) == state
+    assert len(ref.pages) == STATE_SIZE // PAGE_SIZE
+
+
+def test_similar_states_share_pages():
+    store = PageStore()
+    refs = [store.put(_state(i)) for i in range(1, 101)]
+    assert store.states == 100
+    assert store.ratio > 10
+    for i, ref in enumerate(refs, start=1):
+        assert store.get(ref) == _state(i)
+
+
+def test_release_frees_unreferenced_pages():
+    store = PageStore()
+    a = store.put(_state(1))
+    b = store.put(_state(2))
+    shared_only = store.pool_pages
+    store.release(a)
+    assert store.pool_pages < shared_only
+    assert store.get(b) == _state(2)
+    store.release(b)
+    assert store.pool_pages == 0
+    assert store.stored_bytes == 0
@@ -0,0 +1,71 @@
+# tests/ttlang/test_pool.py
+# Work-stealing session pool on the host build of the kernel (threads, no hardware).
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native
+from ttlang.zork_pool import SessionPool
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+pytestmark = pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+
+
+@pytest.fixture(autouse=True, scope="module")
+def _cache(tmp_path_factory):
+    mp = pytest.MonkeyPatch()
+    mp.setenv("ZORK_NATIVE_CACHE", str(tmp_path_factory.mktemp("native")))
+    yield
+    mp.undo()
+
+
+def test_pool_plays_every_script_to_the_end():
+    scripts = [("open mailbox", "read leaflet"), ("north",), ("west", "south")] * 2
+    report = SessionPool(GAME_FILE, workers=2, processes=False).run(scripts)
+    assert [s.id for s in report.sessions] == list(range(len(scripts)))
+    for session, script in zip(report.sessions, scripts):
+        text = "".join(session.output)
+        assert session.done
+        assert text.startswith("ZORK I")
+        # The kernel echoes each command its READ takes; the last READ waits
+        assert all(f"> {command}\n" in text for command in script)
+        assert text.rstrip().endswith(">")
+    assert report.instructions > 0
+    assert report.instructions_per_second > 0
+
+
+def test_idle_worker_steals_from_a_busy_one():
+    # Round-robin dealing gives worker 0 every long script and worker 1 every
+    # short one; worker 1 runs dry first and has to steal to keep busy.
+    long_script = ("open mailbox", "read leaflet", "north", "east", "open window")
+    scripts = [long_script, ("north",)] * 3
+    report = SessionPool(GAME_FILE, workers=2, budget=300, processes=False).run(scripts)
+    assert all(s.done for s in report.sessions)
+    assert all(s.slices > 1 for s in report.sessions)   # the budget forced yields
+    assert report.steals > 0
+
+
+def test_slices_ship_vm_state_not_the_story():
+    import pickle
+    from ttlang import zork_pool
+    zork_pool._init_worker(str(GAME_FILE))
+    result = zork_pool.run_slice(None, "", 300)
+    assert not result.finished and not result.reading
+    assert len(pickle.dumps(result)) < len(GAME_FILE.read_bytes()) // 4
+
+
+def test_slices_return_only_their_own_text():
+    from ttlang import zork_pool
+    zork_pool._init_worker(str(GAME_FILE))
+    session = zork_pool.Session(0, ("open mailbox",))
+    texts = []
+    while not session.done:
+        result = zork_pool.run_slice(*zork_pool._advance(session, 300))
+        texts.append(result.text)
+        zork_pool._record(session, result)
+    assert session.output == texts and session.turn == 1
+    # Each slice carries its own text, not the session's output so far
+    assert texts[0].startswith("ZORK I") and not any("ZORK I" in t for t in texts[1:])
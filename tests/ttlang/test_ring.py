@@ -0,0 +1,146 @@
+# tests/ttlang/test_ring.py
+# Lock-free SPSC rings and the ring runner (threads and a child process, no hardware).
+import multiprocessing
+import sys
+import threading
+import time
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+from ttlang.zork_ring import Channel, RingRunner, SpscRing
+from ttlang.zork_server import HostBackend
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+
+def test_ring_is_bounded_and_ordered_across_threads():
+    ring = SpscRing(slots=8, record_size=32)
+    try:
+        assert all(ring.push(i, b"x") for i in range(8))
+        assert not ring.push(8, b"x")                     # full
+        assert [ring.pop()[0] for _ in range(8)] == list(range(8))
+        assert ring.pop() is None
+
+        n = 20000
+        got = []
+
+        def consume():
+            while len(got) < n:
+                if (record := ring.pop()) is not None:
+                    got.append(record)
+                else:
+                    time.sleep(0)
+
+        t = threading.Thread(target=consume)
+        t.start()
+        for i in range(n):
+            while not ring.push(i, str(i).encode()):
+                time.sleep(0)
+        t.join()
+        assert got == [(i, str(i).encode()) for i in range(n)]
+    finally:
+        ring.close()
+
+
+def _produce(name, n):
+    ring = SpscRing(name=name)
+    for i in range(n):
+        while not ring.push(i, i.to_bytes(4, "little")):
+            pass
+    ring.close()
+
+
+def test_ring_carries_records_between_processes():
+    ring = SpscRing(slots=16, record_size=32)
+    try:
+        child = multiprocessing.Process(target=_produce, args=(ring.name, 500))
+        child.start()
+        got = []
+        while len(got) < 500:
+            if (record := ring.pop()) is not None:
+                got.append(record)
+        child.join(10)
+        assert got == [(i, i.to_bytes(4, "little")) for i in range(500)]
+    finally:
+        ring.close()
+
+
+class _EchoBackend:
+    width = 2
+
+    def __init__(self):
+        self.batches = []
+
+    def new_state(self):
+        return 0
+
+    def run_many(self, states, commands):
+        self.batches.append(list(commands))
+        return [f"{c}#{s}" for s, c in zip(states, commands)], [s + 1 for s in states]
+
+
+def test_runner_batches_one_step_per_session_and_lends_buffers():
+    a, b = Channel(slots=8, buffers=2), Channel(slots=8, buffers=4)
+    try:
+        backend = _EchoBackend()
+        runner = RingRunner(backend, [a, b])
+        assert a.send(1, "n") and a.send(1, "s") and b.send(7, "e")
+
+        assert runner.step() == 2                  # width 2: session 1's "n" and b's "e"
+        assert runner.step() == 1                  # session 1's second command waited
+        assert backend.batches == [["n", "e"], ["s"]]
+
+        first, second = a.receive(), a.receive()
+        assert (first.session, first.text(), second.text()) == (1, "n#0", "s#1")
+        from_b = b.receive()
+        assert from_b.text() == "e#0"
+        assert first.view.obj is not None          # a view into the pool, not a copy
+        b.release(from_b)
+
+        # Both of a's buffers are lent out: its next command waits for a release
+        a.send(2, "w")
+        assert runner.step() == 0
+        a.release(first)
+        assert runner.step() == 1
+        last = a.receive()
+        assert last.text() == "w#0"
+        a.release(second)
+        a.release(last)
+    finally:
+        a.close()
+        b.close()
+
+
+def test_runner_serves_host_sessions_from_threads():
+    channels = [Channel() for _ in range(3)]
+    runner = RingRunner(HostBackend(GAME_FILE), channels)
+    stop = threading.Event()
+    thread = threading.Thread(target=runner.run, args=(stop,))
+    thread.start()
+    try:
+        texts = {}
+
+        def client(c, channel):
+            out = []
+            for command in ("", "open mailbox"):
+                channel.send(c, command)
+                while (span := channel.receive()) is None:
+                    time.sleep(0.001)
+                out.append(span.text())
+                channel.release(span)
+            texts[c] = out
+
+        clients = [threading.Thread(target=client, args=(c, ch)) for c, ch in enumerate(channels)]
+        for t in clients:
+            t.start()
+        for t in clients:
+            t.join(30)
+        assert sorted(texts) == [0, 1, 2]
+        for opening, reply in texts.values():
+            assert "ZORK I" in opening and "leaflet" in reply.lower()
+        assert runner.steps == 6 and runner.launches < 6
+    finally:
+        stop.set()
+        thread.join(5)
+        for ch in channels:
+            ch.close()
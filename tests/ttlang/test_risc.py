@@ -0,0 +1,129 @@
+# tests/ttlang/test_risc.py
+# zork_risc's host side (DeviceBuffers, DeviceSession, ZORK_KEEP_DEVICE) over the
+# stand-in ttnn in stand_in/, which launches the host build of the kernel.
+import sys
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+STAND_IN = Path(__file__).parent / "stand_in"
+
+pytestmark = pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+
+
+@pytest.fixture(autouse=True, scope="module")
+def _cache(tmp_path_factory):
+    mp = pytest.MonkeyPatch()
+    mp.setenv("ZORK_NATIVE_CACHE", str(tmp_path_factory.mktemp("native")))
+    yield
+    mp.undo()
+
+
+@pytest.fixture(scope="module")
+def stand_in():
+    """(zork_risc, ttnn) imported over the stand-in torch and ttnn."""
+    mp = pytest.MonkeyPatch()
+    mp.syspath_prepend(str(STAND_IN))
+    mp.setenv("ZORK_DEVICE_SESSIONS", "4")
+    for name in ("torch", "ttnn", "ttlang.zork_risc", "engines.riscv"):
+        mp.delitem(sys.modules, name, raising=False)
+    import ttnn
+    from ttlang import zork_risc
+    yield zork_risc, ttnn
+    for name in ("torch", "ttnn", "ttlang.zork_risc", "engines.riscv"):
+        sys.modules.pop(name, None)
+    mp.undo()
+
+
+@pytest.mark.parametrize("keep", ["", "1"])
+def test_run_session_matches_native(stand_in, monkeypatch, keep):
+    zork_risc, _ = stand_in
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", keep)
+    risc_state = native_state = None
+    for command, undo in [("open mailbox", 0), ("north", 0), ("look", 1)]:
+        risc = zork_risc.run_session(GAME_FILE, risc_state, command=command, undo=undo, num_batches=300)
+        native = zork_native.run_session(GAME_FILE, native_state, command=command, undo=undo, num_batches=300)
+        assert risc == native
+        risc_state, native_state = risc[1], native[1]
+
+
+@pytest.mark.parametrize("keep", ["", "1"])
+def test_run_sessions_match_native(stand_in, monkeypatch, keep):
+    zork_risc, _ = stand_in
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", keep)
+    commands = ["open mailbox", "north", "take all"]
+    risc = zork_risc.run_sessions(GAME_FILE, commands, num_batches=150)
+    native = zork_native.run_sessions(GAME_FILE, commands, num_batches=150)
+    assert risc == native
+    risc = zork_risc.run_sessions(GAME_FILE, ["look"] * 3, risc[1], num_batches=100)
+    native = zork_native.run_sessions(GAME_FILE, ["look"] * 3, native[1], num_batches=100)
+    assert risc == native
+
+
+def test_device_reopened_before_third_launch_unless_kept(stand_in, monkeypatch):
+    zork_risc, ttnn = stand_in
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", "")
+    ttnn.stats.clear()
+    zork_risc.run_sessions(GAME_FILE, ["look"], num_batches=20)
+    assert ttnn.stats["launches"] == 20
+    assert ttnn.stats["opens"] == 20 // zork_risc.LAUNCHES_PER_OPEN
+
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", "1")
+    ttnn.stats.clear()
+    zork_risc.run_sessions(GAME_FILE, ["look"], num_batches=20)
+    assert ttnn.stats["opens"] == 1 and ttnn.stats["launches"] == 20
+
+
+def test_states_resident_between_launches_of_a_device_session(stand_in, monkeypatch):
+    zork_risc, ttnn = stand_in
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", "")
+    with zork_risc.DeviceSession(GAME_FILE, 1, [None]) as session:
+        first = session.buffers()
+        first.launch()
+        ttnn.stats.clear()
+        assert session.buffers() is first
+        first.launch()
+        # No new buffers and no uploads: at most the state slab is read back
+        assert ttnn.stats["allocations"] == ttnn.stats["to_device"] == 0
+        assert ttnn.stats["from_device"] <= zork_risc.UNDO_RING_OFFSET
+        again = session.buffers()
+        assert again is not first and session.opens == 2
+        again.launch()
+        state = session.states()[0]
+    assert state == zork_native.run_session(GAME_FILE, num_batches=3)[1]
+
+
+def test_ring_crosses_only_around_ring_launches(stand_in, monkeypatch):
+    zork_risc, ttnn = stand_in
+    monkeypatch.setenv("ZORK_KEEP_DEVICE", "")
+    _, state = zork_risc.run_session(GAME_FILE, num_batches=300)
+
+    ring = []
+    download, upload = zork_risc.download_state, ttnn.copy_host_to_device_tensor
+    monkeypatch.setattr(zork_risc, "download_state",
+                        lambda t: (ring.append(t) if t.shape[0] == zork_risc.RING_SIZE else None) or download(t))
+    monkeypatch.setattr(ttnn, "copy_host_to_device_tensor",
+                        lambda h, t: (ring.append(t) if t.shape[0] == zork_risc.RING_SIZE else None) or upload(h, t))
+    ttnn.stats.clear()
+    for command in ["open mailbox", "north"]:
+        _, state = zork_risc.run_session(GAME_FILE, state, command=command, num_batches=300)
+    # One READ snapshot: the ring goes up before its launch and comes back after
+    assert ttnn.stats["launches"] > 50
+    assert len(ring) == 2
+
+
+def test_riscv_engine_continues_the_game_between_turns(stand_in, monkeypatch):
+    from engines.riscv import STARTUP_BATCHES, STEP_BATCHES, RiscVEngine
+    with RiscVEngine(str(GAME_FILE)) as engine:
+        opening = engine.startup()
+        text = engine.step("open mailbox")
+        state = engine._session.state
+    (native_opening,), states = zork_native.run_sessions(GAME_FILE, [""], num_batches=STARTUP_BATCHES)
+    (native_text,), (native_state,) = zork_native.run_sessions(
+        GAME_FILE, ["open mailbox"], states, num_batches=STEP_BATCHES)
+    assert (opening, text, state) == (native_opening, native_text, native_state)
+    assert not engine.game_over
@@ -0,0 +1,100 @@
+# tests/ttlang/test_server.py
+# Session server over a Unix socket with the host backend (no hardware).
+import asyncio
+import contextlib
+import sys
+import threading
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang.zork_server import HostBackend, ZorkClient, ZorkServer
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+
+@pytest.fixture
+def server(tmp_path):
+    path = str(tmp_path / "zork.sock")
+    srv = ZorkServer(HostBackend(GAME_FILE), path)
+    loop = asyncio.new_event_loop()
+    ready = threading.Event()
+    stop = asyncio.Event()
+
+    async def main():
+        started = asyncio.Event()
+        task = asyncio.create_task(srv.serve(started))
+        await started.wait()
+        ready.set()
+        await stop.wait()
+        task.cancel()
+        with contextlib.suppress(asyncio.CancelledError):
+            await task
+
+    thread = threading.Thread(target=lambda: loop.run_until_complete(main()), daemon=True)
+    thread.start()
+    ready.wait(5)
+    yield path
+    loop.call_soon_threadsafe(stop.set)
+    thread.join(5)
+    loop.close()
+
+
+def test_create_step_and_metrics(server):
+    client = ZorkClient(server)
+    sid, opening = client.create()
+    assert "ZORK I" in opening
+    assert "leaflet" in client.step(sid, "open mailbox").lower()
+    m = client.metrics()
+    assert m["sessions"] == 1 and m["steps"] == 2 and m["queue_depth"] == 0
+    assert m["latency_ms"]["p50"] > 0
+    client.close()
+
+
+def test_snapshot_restore_forks_a_session(server):
+    client = ZorkClient(server)
+    sid, _ = client.create()
+    client.step(sid, "open mailbox")
+    image = client.snapshot(sid)
+    fork = client.restore(image)
+    assert fork != sid
+    assert "leaflet" in client.step(fork, "take leaflet").lower()
+    client.close_session(sid)
+    assert client.metrics()["sessions"] == 1
+    with pytest.raises(RuntimeError):
+        client.step(sid, "look")
+    client.close()
+
+
+def test_restore_replaces_only_open_sessions(server):
+    client = ZorkClient(server)
+    sid, _ = client.create()
+    image = client.snapshot(sid)
+    client.step(sid, "open mailbox")
+    assert client.restore(image, sid) == sid
+    assert "opening the small mailbox" in client.step(sid, "open mailbox").lower()
+    with pytest.raises(RuntimeError):
+        client.restore(image, sid + 1)        # not issued yet
+    assert client.create()[0] == sid + 1
+    client.close()
+
+
+def test_concurrent_clients_share_launches(server):
+    clients = [ZorkClient(server) for _ in range(6)]
+    results = []
+
+    def play(client):
+        sid, _ = client.create()
+        results.append(client.step(sid, "north"))
+
+    threads = [threading.Thread(target=play, args=(c,)) for c in clients]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    m = clients[0].metrics()
+    assert len(results) == 6 and m["steps"] == 12
+    assert m["launches"] <= m["steps"]
+    for c in clients:
+        c.close()
@@ -0,0 +1,105 @@
+# tests/ttlang/test_speculate.py
+# Speculation logic with a fake runner, and against the host build of the kernel.
+import sys
+import threading
+import time
+from pathlib import Path
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+import pytest
+
+from ttlang import zork_native
+from ttlang.zork_speculate import SpeculativeSession, predict_commands
+
+GAME_FILE = Path(__file__).parent.parent.parent / "game" / "zork1.z3"
+
+
+def _fake_runner(calls, batch=lambda: None):
+    """Runner whose state is the command history (one entry per batch), so results are easy to check."""
+    def play(state, command):
+        batch()
+        new_state = (state or b"") + command.encode() + b";"
+        return f"did {command}. Paths lead north and west.", new_state
+
+    def run_many(states, commands, num_batches):
+        calls.append(tuple(commands))
+        results = [("", s) for s in states]
+        for _ in range(num_batches):
+            results = [(text + play(s, c)[0], play(s, c)[1]) for (text, s), c in zip(results, commands)]
+        return [r[0] for r in results], [r[1] for r in results]
+
+    return run_many
+
+
+def test_predict_commands_puts_mentioned_exits_first():
+    cmds = predict_commands("A path leads west; the door to the north is open.", k=4)
+    assert cmds[:2] == ["west", "north"]
+    assert len(cmds) == 4
+    assert predict_commands("Exits: north.", k=0) == []
+
+
+def test_predict_commands_filters_through_vocabulary():
+    vocab = frozenset({"north", "look", "invent"})
+    assert predict_commands("Exits: north, east.", vocab, k=8) == ["north", "look", "inventory"]
+
+
+def test_speculated_command_is_served_from_cache():
+    calls = []
+    spec = SpeculativeSession("unused.z3", num_batches=1, vocabulary=frozenset(),
+                              run_many=_fake_runner(calls), width=2)
+    spec.start()
+    spec.wait()
+    calls.clear()
+
+    text = spec.step("  North ")
+    assert text.startswith("did north")
+    assert spec.hits == 1
+    assert spec.state == b";north;"
+    assert ("north",) not in calls
+
+
+def test_unpredicted_command_runs_on_the_device():
+    calls = []
+    spec = SpeculativeSession("unused.z3", num_batches=1, vocabulary=frozenset(), top_k=0,
+                              run_many=_fake_runner(calls), width=2)
+    spec.start()
+    assert spec.step("xyzzy").startswith("did xyzzy")
+    assert spec.misses == 2
+    assert ("xyzzy",) in calls
+
+
+def test_real_command_preempts_speculation_between_launches():
+    calls, speculated, launched = [], [], threading.Event()
+
+    def batch():
+        if threading.current_thread() is not threading.main_thread():
+            speculated.append(1)
+            launched.set()
+            time.sleep(0.001)
+
+    spec = SpeculativeSession("unused.z3", num_batches=50, vocabulary=frozenset(),
+                              run_many=_fake_runner(calls, batch), width=2)
+    spec.start()
+    launched.wait()
+    spec.step("xyzzy")
+    # The miss cut the first speculated group (2 commands × 50 batches) short
+    assert 0 < len(speculated) < 2 * 50
+    assert spec.state.endswith(b"xyzzy;" * 50)
+
+
+@pytest.mark.skipif(not zork_native.available(), reason="no C++ compiler")
+def test_hits_reach_the_states_misses_reach_on_the_kernel(tmp_path, monkeypatch):
+    monkeypatch.setenv("ZORK_NATIVE_CACHE", str(tmp_path))
+
+    def session(top_k):
+        run_many = lambda states, commands, num_batches: zork_native.run_sessions(
+            GAME_FILE, commands, states, num_batches=num_batches)
+        return SpeculativeSession(GAME_FILE, num_batches=40, top_k=top_k, vocabulary=frozenset(),
+                                  run_many=run_many, width=zork_native.MAX_SESSIONS)
+
+    spec, plain = session(8), session(0)
+    assert spec.start() == plain.start()
+    spec.wait()
+    assert spec.step("north") == plain.step("north")
+    assert (spec.hits, plain.hits) == (1, 0)
+    assert spec.state == plain.state
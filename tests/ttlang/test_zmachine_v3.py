@@ -59,3 +59,25 @@ def test_interpret_zork_title():
     zm.interpret(500)
     text = "".join(zm.output)
     assert "ZORK" in text, f"Expected 'ZORK' in output, got: {text[:200]!r}"
+
+def test_save_state_resumes_identically():
+    """A machine rebuilt from the story and save_state() plays on the same."""
+    import random
+    from ttlang.zmachine_v3 import ZMachineV3
+    story = GAME_FILE.read_bytes()
+    zm = ZMachineV3(story)
+    zm.interpret(5000)
+    zm.input_command = "open mailbox"
+    zm.interpret(300)
+    zm.flush_output()
+    state = zm.save_state()
+    assert len(state["memory"]) == zm.static_base < len(story)
+
+    other = ZMachineV3.from_state(story, state)
+    for machine in (zm, other):
+        random.seed(1)   # RANDOM draws from the module generator
+        machine.interpret(5000)
+        machine.input_command = "north"
+        machine.interpret(5000)
+    assert other.flush_output() == zm.flush_output()
+    assert other.save_state() == zm.save_state()
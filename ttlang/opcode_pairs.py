@@ -0,0 +1,150 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+opcode_pairs.py — Measure adjacent opcode pair/triple frequencies for a story.
+
+The superinstructions in kernels/zork_interpreter_l1.cpp (ZORK_FUSE) were chosen
+from these numbers. Re-run this when adding a story or a fused handler: a pair is
+only worth fusing if it shows up in the top of the list across several games.
+
+Runs the pure-Python reference interpreter (ttlang/zmachine_v3.py) through the
+opening and a short command script — no hardware or ttnn needed. Two views:
+
+    pairs / triples   — opcode names of consecutive instructions
+    stack-through     — pairs where the first instruction stores to the stack
+                        and the second pops it (the ones a fused handler can
+                        forward without the push/pop round trip)
+
+Usage:
+    python ttlang/opcode_pairs.py game/zork1.z3 game/zork2.z3 game/zork3.z3
+    python ttlang/opcode_pairs.py game/zork1.z3 --top 40
+"""
+from __future__ import annotations
+
+import argparse
+import sys
+from collections import Counter
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang.zmachine_v3 import ZMachineV3
+
+# Commands that walk the parser, the object code and a few daemons.
+DEFAULT_SCRIPT = [
+    "open mailbox", "read leaflet", "north", "east", "open window", "enter",
+    "take all", "west", "move rug", "open trapdoor", "turn on lamp", "down",
+    "south", "inventory",
+]
+
+_NAMES_2OP = {
+    0x01: "JE", 0x02: "JL", 0x03: "JG", 0x04: "DEC_CHK", 0x05: "INC_CHK",
+    0x06: "JIN", 0x07: "TEST", 0x08: "OR", 0x09: "AND", 0x0A: "TEST_ATTR",
+    0x0B: "SET_ATTR", 0x0C: "CLEAR_ATTR", 0x0D: "STORE", 0x0E: "INSERT_OBJ",
+    0x0F: "LOADW", 0x10: "LOADB", 0x11: "GET_PROP", 0x12: "GET_PROP_ADDR",
+    0x13: "GET_NEXT_PROP", 0x14: "ADD", 0x15: "SUB", 0x16: "MUL", 0x17: "DIV",
+    0x18: "MOD",
+}
+_NAMES_1OP = {
+    0x00: "JZ", 0x01: "GET_SIBLING", 0x02: "GET_CHILD", 0x03: "GET_PARENT",
+    0x04: "GET_PROP_LEN", 0x05: "INC", 0x06: "DEC", 0x07: "PRINT_ADDR",
+    0x09: "REMOVE_OBJ", 0x0A: "PRINT_OBJ", 0x0B: "RET", 0x0C: "JUMP",
+    0x0D: "PRINT_PADDR", 0x0E: "LOAD", 0x0F: "NOT",
+}
+_NAMES_0OP = {
+    0x00: "RTRUE", 0x01: "RFALSE", 0x02: "PRINT", 0x03: "PRINT_RET",
+    0x05: "SAVE", 0x06: "RESTORE", 0x07: "RESTART", 0x08: "RET_POPPED",
+    0x09: "POP", 0x0A: "QUIT", 0x0B: "NEW_LINE", 0x0C: "SHOW_STATUS",
+    0x0D: "VERIFY",
+}
+_NAMES_VAR = {
+    0x00: "CALL", 0x01: "STOREW", 0x02: "STOREB", 0x03: "PUT_PROP",
+    0x04: "READ", 0x05: "PRINT_CHAR", 0x06: "PRINT_NUM", 0x07: "RANDOM",
+    0x08: "PUSH", 0x09: "PULL",
+}
+
+# Opcodes whose store byte follows the operands directly (no branch before it).
+_STORE_OPS = {"LOADW", "LOADB", "ADD", "SUB", "MUL", "DIV", "MOD", "OR", "AND",
+              "GET_PROP", "GET_PROP_ADDR", "GET_NEXT_PROP", "LOAD", "NOT",
+              "GET_PARENT", "GET_PROP_LEN", "CALL", "RANDOM"}
+
+
+def opcode_name(b: int) -> str:
+    """Name of the instruction whose first byte is b (V3 opcode tables)."""
+    if b < 0x80:
+        return _NAMES_2OP.get(b & 0x1F, f"2OP_{b & 0x1F:02X}")
+    if b < 0xB0:
+        return _NAMES_1OP.get(b & 0x0F, f"1OP_{b & 0x0F:02X}")
+    if b < 0xC0:
+        return _NAMES_0OP.get(b & 0x0F, f"0OP_{b & 0x0F:02X}")
+    if b < 0xE0:
+        return _NAMES_2OP.get(b & 0x1F, f"2OP_{b & 0x1F:02X}")
+    return _NAMES_VAR.get(b & 0x1F, f"VAR_{b & 0x1F:02X}")
+
+
+class _CountingZMachine(ZMachineV3):
+    """ZMachineV3 that tallies opcode sequences as it executes."""
+
+    def __init__(self, game_bytes: bytes) -> None:
+        super().__init__(game_bytes)
+        self.singles: Counter[str] = Counter()
+        self.pairs: Counter[tuple[str, str]] = Counter()
+        self.triples: Counter[tuple[str, str, str]] = Counter()
+        self.stack_through: Counter[tuple[str, str]] = Counter()
+        self._prev: list[str] = []
+        self._prev_pushed = False
+
+    def _execute_one(self) -> None:
+        name = opcode_name(self.memory[self.pc])
+        sp_before = len(self.stack)
+        self.singles[name] += 1
+        if self._prev:
+            self.pairs[(self._prev[-1], name)] += 1
+            if len(self._prev) == 2:
+                self.triples[(self._prev[0], self._prev[1], name)] += 1
+        super()._execute_one()
+        # A stack-through pair: the previous instruction left exactly one new
+        # value on the stack and this one took it back off.
+        if self._prev_pushed and len(self.stack) < sp_before:
+            self.stack_through[(self._prev[-1], name)] += 1
+        self._prev_pushed = name in _STORE_OPS and len(self.stack) == sp_before + 1
+        self._prev = (self._prev + [name])[-2:]
+
+
+def measure(game_path: Path, script: list[str]) -> _CountingZMachine:
+    """Run the opening plus each scripted command to its next READ."""
+    zm = _CountingZMachine(game_path.read_bytes())
+    for command in [""] + script:
+        zm.input_command = command
+        zm.interpret(2000)
+        while zm.running and not zm.waiting_for_input:
+            zm.interpret(2000)
+        if not zm.running:
+            break
+    return zm
+
+
+def _report(title: str, counts: Counter, total: int, top: int) -> None:
+    print(f"  {title}")
+    for key, n in counts.most_common(top):
+        print(f"    {100.0 * n / total:6.2f}%  {' ; '.join(key)}")
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("games", nargs="+", type=Path, help="Z-machine story files")
+    parser.add_argument("--top", type=int, default=20, help="rows per table")
+    args = parser.parse_args()
+
+    for game in args.games:
+        zm = measure(game, DEFAULT_SCRIPT)
+        total = sum(zm.singles.values())
+        print(f"{game}: {total} instructions")
+        _report("pairs", zm.pairs, total, args.top)
+        _report("triples", zm.triples, total, args.top // 2)
+        _report("stack-through pairs", zm.stack_through, total, args.top // 2)
+        print()
+
+
+if __name__ == "__main__":
+    main()
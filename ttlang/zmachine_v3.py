@@ -51,6 +51,7 @@ class ZMachineV3:
         self.global_vars_addr = (m[0x0C] << 8) | m[0x0D]  # global variables
         self.object_table    = (m[0x0A] << 8) | m[0x0B]  # object table
         self.dictionary_addr = (m[0x08] << 8) | m[0x09]  # dictionary
+        self.static_base     = (m[0x0E] << 8) | m[0x0F]  # end of dynamic memory
 
         # Packed-address multipliers differ by version (Z-machine spec §1.2.3).
         # V3: packed = addr × 2.  V5: packed = addr × 4 + 8 × header_offset.
@@ -130,6 +131,46 @@ class ZMachineV3:
         # restore the PC when no input is available, so READ re-executes on resume.
         self._instr_pc: int = self.initial_pc
 
+    # ------------------------------------------------------------------
+    # VM state — what a session carries between interpret() calls
+    # ------------------------------------------------------------------
+
+    def save_state(self) -> dict:
+        """The mutable VM state: dynamic memory, registers, stack and call frames.
+
+        Static memory is the story's own, so a few KB describe a whole game.
+        Pending output is not included (flush_output() first).
+        """
+        return {
+            "memory": bytes(self.memory[:self.static_base]),
+            "pc": self.pc, "stack": list(self.stack),
+            "frames": [dict(f, locals=list(f["locals"])) for f in self.frames],
+            "instr_pc": self._instr_pc, "window": self.current_window,
+            "input": self.input_command, "input_pos": self.input_pos,
+            "running": self.running, "game_over": self.game_over,
+            "waiting": self.waiting_for_input, "count": self.instruction_count,
+        }
+
+    def load_state(self, state: dict) -> None:
+        """Resume at a save_state() taken on a machine for the same story."""
+        memory = state["memory"]
+        if len(memory) != self.static_base:
+            raise ValueError("state is for a different story")
+        self.memory[:self.static_base] = memory
+        self.pc, self.stack = int(state["pc"]), list(state["stack"])
+        self.frames = [dict(f, locals=list(f["locals"])) for f in state["frames"]]
+        self._instr_pc, self.current_window = int(state["instr_pc"]), int(state["window"])
+        self.input_command, self.input_pos = str(state["input"]), int(state["input_pos"])
+        self.running, self.game_over = bool(state["running"]), bool(state["game_over"])
+        self.waiting_for_input, self.instruction_count = bool(state["waiting"]), int(state["count"])
+
+    @classmethod
+    def from_state(cls, game_bytes: bytes, state: dict) -> ZMachineV3:
+        """A machine for game_bytes, which is also its RESTART source, resumed at state."""
+        zm = cls(game_bytes)
+        zm.load_state(state)
+        return zm
+
     # ------------------------------------------------------------------
     # Memory access helpers
     # ------------------------------------------------------------------
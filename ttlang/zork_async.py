@@ -0,0 +1,226 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_async.py — Coroutine sessions that share backend launches.
+
+run_zork() and run_session() block until their batches finish, so a driver with
+many games (the TUI, bots, the session server) needed a thread per game. Here a
+game is a Session and a step is a coroutine:
+
+    async with SessionLoop(HostBackend("game/zork1.z3")) as loop:
+        session = await loop.open()
+        print(session.opening)
+        print(await session.step("open mailbox"))
+
+step() queues the command and suspends. The loop's runner task takes as many
+pending steps as the backend's width allows, one per session, in arrival order.
+It runs them in one backend.run_many() call on an executor thread, so the event
+loop stays free. Then it resumes each waiting coroutine with its text.
+snapshot() and replace() wait for the launch in flight, since run_many() may
+mutate the states it was given. Sessions
+that step at the same time share launches. On the device that is up to
+DEVICE_SESSIONS games per run_sessions() launch sequence. Thousands of sessions
+need no threads of their own.
+
+Backends are the ZorkServer ones (ttlang/zork_server.py): HostBackend,
+DeviceBackend. ZorkServer is a SessionLoop behind a socket.
+"""
+from __future__ import annotations
+
+import asyncio
+import itertools
+import time
+from collections import deque
+from dataclasses import dataclass
+from typing import Any
+
+# Step latencies kept for the percentile metrics.
+LATENCY_WINDOW = 1000
+
+
+@dataclass
+class _Step:
+    session: int
+    command: str
+    future: asyncio.Future
+    queued: float
+
+
+class Session:
+    """One game on a SessionLoop."""
+
+    def __init__(self, loop: "SessionLoop", sid: int, opening: str = "") -> None:
+        self.loop = loop
+        self.id = sid
+        self.opening = opening
+
+    async def step(self, command: str) -> str:
+        """Run command; resumes when the launch that carries it completes."""
+        return await self.loop.step(self.id, command)
+
+    @property
+    def state(self) -> Any:
+        return self.loop.states[self.id]
+
+    async def snapshot(self) -> bytes:
+        return await self.loop.snapshot(self.id)
+
+    def close(self) -> None:
+        self.loop.close_session(self.id)
+
+
+class SessionLoop:
+    """Coalesce the pending steps of many sessions into shared backend launches."""
+
+    def __init__(self, backend: Any) -> None:
+        self.backend = backend
+        self.states: dict[int, Any] = {}
+        self._ids = itertools.count(1)
+        self._pending: deque[_Step] = deque()
+        self._wake: asyncio.Event | None = None
+        self._runner: asyncio.Task | None = None
+        # Held while a launch has the states on the executor thread
+        self._launch = asyncio.Lock()
+        self.launches = 0
+        self.steps = 0
+        self._latency: deque[float] = deque(maxlen=LATENCY_WINDOW)
+
+    # -- lifetime ----------------------------------------------------------
+
+    def start(self) -> None:
+        """Start the runner task on the running event loop."""
+        if self._runner is None:
+            self._wake = asyncio.Event()
+            self._runner = asyncio.create_task(self._run())
+
+    async def stop(self) -> None:
+        if self._runner is not None:
+            self._runner.cancel()
+            try:
+                await self._runner
+            except asyncio.CancelledError:
+                pass
+            self._runner = None
+        while self._pending:
+            step = self._pending.popleft()
+            if not step.future.done():
+                step.future.cancel()
+
+    async def __aenter__(self) -> "SessionLoop":
+        self.start()
+        return self
+
+    async def __aexit__(self, *exc: object) -> None:
+        await self.stop()
+
+    # -- sessions ----------------------------------------------------------
+
+    async def open(self) -> Session:
+        """A new game, run to its first READ (the opening text is session.opening)."""
+        session = self.attach(self.backend.new_state())
+        session.opening = await session.step("")
+        return session
+
+    def attach(self, state: Any) -> Session:
+        """Add a session with an existing state, under a new id."""
+        sid = next(self._ids)
+        self.states[sid] = state
+        return Session(self, sid)
+
+    async def replace(self, sid: int, state: Any) -> Session:
+        """Give open session sid a new state, between launches."""
+        async with self._launch:
+            if sid not in self.states:
+                raise KeyError(f"no session {sid}")
+            self.states[sid] = state
+        return Session(self, sid)
+
+    async def snapshot(self, sid: int) -> bytes:
+        """backend.snapshot() of session sid, between launches (run_many may mutate states)."""
+        async with self._launch:
+            if sid not in self.states:
+                raise KeyError(f"no session {sid}")
+            return self.backend.snapshot(self.states[sid])
+
+    def close_session(self, sid: int) -> None:
+        self.states.pop(sid, None)
+
+    async def step(self, sid: int, command: str) -> str:
+        text, _ = await self.step_batch(sid, command)
+        return text
+
+    async def step_batch(self, sid: int, command: str) -> tuple[str, int]:
+        """step(), plus how many steps shared the backend call that ran it."""
+        if sid not in self.states:
+            raise KeyError(f"no session {sid}")
+        if self._runner is None:
+            raise RuntimeError("SessionLoop is not started")
+        future = asyncio.get_running_loop().create_future()
+        self._pending.append(_Step(sid, command, future, time.perf_counter()))
+        self._wake.set()
+        return await future
+
+    # -- runner ------------------------------------------------------------
+
+    def _take_batch(self) -> list[_Step]:
+        """Up to backend.width pending steps, at most one per session, in arrival order."""
+        batch: list[_Step] = []
+        seen: set[int] = set()
+        keep: deque[_Step] = deque()
+        while self._pending and len(batch) < self.backend.width:
+            step = self._pending.popleft()
+            if step.session in seen:
+                keep.append(step)        # runs after this session's earlier step
+            else:
+                seen.add(step.session)
+                batch.append(step)
+        keep.extend(self._pending)
+        self._pending = keep
+        return batch
+
+    async def _run(self) -> None:
+        loop = asyncio.get_running_loop()
+        while True:
+            if not self._pending:
+                self._wake.clear()
+                await self._wake.wait()
+                continue
+            batch = self._take_batch()
+            async with self._launch:
+                live = [s for s in batch if s.session in self.states]
+                for step in batch:
+                    if step.session not in self.states:
+                        step.future.set_exception(KeyError(f"no session {step.session}"))
+                if not live:
+                    continue
+                states = [self.states[s.session] for s in live]
+                try:
+                    texts, states = await loop.run_in_executor(
+                        None, self.backend.run_many, states, [s.command for s in live])
+                except Exception as exc:  # a failed launch fails its steps, not the loop
+                    for step in live:
+                        step.future.set_exception(exc)
+                    continue
+                for step, state in zip(live, states):
+                    if step.session in self.states:
+                        self.states[step.session] = state
+            self.launches += 1
+            now = time.perf_counter()
+            for step, text in zip(live, texts):
+                self.steps += 1
+                self._latency.append(now - step.queued)
+                if not step.future.done():
+                    step.future.set_result((text, len(live)))
+
+    def metrics(self) -> dict:
+        lat = sorted(self._latency)
+        pct = lambda p: round(1000 * lat[min(len(lat) - 1, int(p * len(lat)))], 3) if lat else 0.0
+        return {
+            "sessions": len(self.states),
+            "queue_depth": len(self._pending),
+            "steps": self.steps,
+            "launches": self.launches,
+            "mean_batch": round(self.steps / self.launches, 2) if self.launches else 0.0,
+            "latency_ms": {"p50": pct(0.50), "p95": pct(0.95), "p99": pct(0.99),
+                           "max": pct(1.0)},
+        }
@@ -0,0 +1,161 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_dedup.py — Run each distinct kernel session once and share the result.
+
+Bulk bot play and exploration start thousands of sessions from a handful of
+states with a handful of commands, so many sessions are exact duplicates. The
+kernel is deterministic (its RANDOM always returns 1). Two sessions with the
+same state bytes and the same input therefore end a run with the same text and
+state, so only one of them needs to run.
+
+run_deduped() takes any number of (state, command) sessions:
+    1. Group the sessions by (state bytes, command).
+    2. Pack one representative per group into the kernel's time-sliced session
+       slots, MAX_SESSIONS per launch sequence (kernel ZORK_SESSIONS). The story
+       load and launch overhead are shared by every slot.
+    3. Fan each representative's text and state back out to its group. The
+       group shares one bytes object.
+
+A run costs one slot per distinct (state, command) pair, not one per session.
+DedupStats.fan_out is that saving. Sessions that differ anywhere run on their
+own, at the scalar speed of the kernel.
+
+This is a cache over whole runs, not a vectorised interpreter. Sessions that
+share a PC but not their whole state still run one at a time here;
+zork_lockstep.py advances those groups together in AVX2 lanes.
+
+The runner is run_sessions() from zork_native (host, default) or zork_risc
+(device); both take per-session commands and states, up to MAX_SESSIONS on the
+host and zork_risc.DEVICE_SESSIONS on the device.
+
+Usage:
+    python ttlang/zork_dedup.py game/zork1.z3 --bots 256 --turns 6
+"""
+from __future__ import annotations
+
+import argparse
+import hashlib
+import random
+import sys
+import time
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Callable
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang.zork_state import MAX_SESSIONS
+
+# (commands, states) -> (texts, states), at most MAX_SESSIONS sessions per call
+RunSessions = Callable[[list[str], list[bytes | None]], tuple[list[str], list[bytes]]]
+
+
+@dataclass
+class DedupStats:
+    sessions: int = 0     # sessions advanced
+    groups: int = 0       # distinct (state, command) pairs actually run
+    calls: int = 0        # run_sessions() calls (launch sequences)
+
+    @property
+    def fan_out(self) -> float:
+        """Sessions per group run: the saving over one run per session."""
+        return self.sessions / self.groups if self.groups else 0.0
+
+    def add(self, other: "DedupStats") -> None:
+        self.sessions += other.sessions
+        self.groups += other.groups
+        self.calls += other.calls
+
+
+def _key(state: bytes | None, command: str) -> tuple[bytes, str]:
+    digest = hashlib.blake2b(state, digest_size=16).digest() if state else b""
+    return digest, command
+
+
+def native_runner(game_path: str | Path, num_batches: int | None = None) -> RunSessions:
+    """A RunSessions over the host build of the kernel (zork_native)."""
+    from ttlang.zork_native import run_sessions
+    return lambda commands, states: run_sessions(game_path, commands, states, num_batches)
+
+
+def device_runner(game_path: str | Path, num_batches: int | None = None) -> RunSessions:
+    """A RunSessions over the device (zork_risc; needs ttnn)."""
+    from ttlang.zork_risc import run_sessions
+    return lambda commands, states: run_sessions(game_path, commands, states, num_batches)
+
+
+def run_deduped(
+    run: RunSessions,
+    commands: list[str],
+    states: list[bytes | None] | None = None,
+    width: int = MAX_SESSIONS,
+) -> tuple[list[str], list[bytes], DedupStats]:
+    """
+    Advance every session by one run, running each distinct (state, command) once.
+
+    Args:
+        run:      RunSessions for the target (native_runner / device_runner).
+        commands: One command per session.
+        states:   Per-session state bytes; None (or a short list) = fresh games.
+        width:    Sessions per run() call (the kernel's session count).
+
+    Returns:
+        (texts, states, stats), texts and states in session order.
+    """
+    n = len(commands)
+    states = list(states or []) + [None] * (n - len(states or []))
+
+    groups: dict[tuple[bytes, str], list[int]] = {}
+    for i, (state, command) in enumerate(zip(states, commands)):
+        groups.setdefault(_key(state, command), []).append(i)
+    members = list(groups.values())
+
+    texts: list[str] = [""] * n
+    out: list[bytes] = [b""] * n
+    stats = DedupStats(sessions=n, groups=len(members))
+    for start in range(0, len(members), width):
+        chunk = members[start:start + width]
+        lead = [m[0] for m in chunk]
+        chunk_texts, chunk_states = run([commands[i] for i in lead], [states[i] for i in lead])
+        stats.calls += 1
+        for group, text, state in zip(chunk, chunk_texts, chunk_states):
+            for i in group:
+                texts[i], out[i] = text, state
+    return texts, out, stats
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--bots", type=int, default=256)
+    parser.add_argument("--turns", type=int, default=6)
+    parser.add_argument("--batches", type=int, default=30, help="launches per turn")
+    parser.add_argument("--commands", default="north,south,east,west,open mailbox,take all",
+                        help="comma-separated command pool the bots pick from")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--device", action="store_true", help="run on the device (ttnn)")
+    args = parser.parse_args()
+
+    run = (device_runner if args.device else native_runner)(args.game, args.batches)
+    width = MAX_SESSIONS
+    if args.device:
+        from ttlang.zork_risc import DEVICE_SESSIONS as width
+    pool = args.commands.split(",")
+    rng = random.Random(args.seed)
+    states: list[bytes | None] = [None] * args.bots
+    total = DedupStats()
+    began = time.perf_counter()
+    for turn in range(args.turns):
+        commands = [rng.choice(pool) for _ in range(args.bots)]
+        _, states, stats = run_deduped(run, commands, states, width)
+        total.add(stats)
+        print(f"turn {turn + 1}: {stats.groups} runs for {stats.sessions} bots "
+              f"({stats.fan_out:.1f}x)", flush=True)
+    seconds = time.perf_counter() - began
+    print(f"{total.sessions} session-turns in {seconds:.2f}s using {total.groups} runs "
+          f"and {total.calls} launch sequences: {total.fan_out:.1f}x over one run per session")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_explore.py — Breadth-first state-space explorer on the RISC-V kernel.
+
+Walkthrough testing and training data both need the set of game states reachable
+from a start state. Explorer keeps a frontier of states and expands every state
+with every command of a command set. Expansions run DEVICE_SESSIONS at a time in
+the kernel's time-sliced sessions (zork_risc.run_sessions), so once more than
+one session is validated on hardware, one launch advances several (state,
+command) pairs.
+
+Each result is hashed over its VM context and dynamic memory (zork_state.state_hash).
+The hash goes into a transposition table. A state already in the table adds only
+an edge, so the frontier grows only with new states. The result is a state graph
+(nodes = unique states, edges = commands). room_graph() collapses it to rooms via
+the player's location global.
+
+Only states are compared, so the default runner is headless (HOST_FLAG_HEADLESS):
+print opcodes skip the Z-string decoder and write event records instead of text.
+
+Frontier states wait in a PageStore (zork_pages), so a wide frontier costs the
+pages that differ between its states rather than STATE_SIZE each.
+
+Throughput is reported as states expanded per second. The host drives a single
+core today, so throughput grows with the session width (DEVICE_SESSIONS) and not with
+the core count. Once run_sessions spreads sessions over several cores, it will
+grow with the core count too.
+
+Usage:
+    python ttlang/zork_explore.py game/zork1.z3 --depth 2
+    python ttlang/zork_explore.py game/zork1.z3 --depth 3 --dot rooms.dot
+"""
+from __future__ import annotations
+
+import argparse
+import sys
+import time
+from collections import deque
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Callable
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang.zork_pages import PageStore
+from ttlang.zork_state import current_room, is_finished, object_name, state_hash
+
+# Commands tried from every state: movement plus a few state-changing verbs.
+DEFAULT_COMMANDS: tuple[str, ...] = (
+    "north", "south", "east", "west", "up", "down",
+    "take all", "open door", "open window", "enter",
+)
+
+RunMany = Callable[[list[bytes | None], list[str]], tuple[list[str], list[bytes]]]
+
+
+@dataclass
+class StateNode:
+    """One unique game state."""
+    key: str                 # state_hash()
+    room: int                # location object number
+    depth: int               # commands from the start state
+    path: tuple[str, ...]    # one shortest command sequence that reaches it
+    finished: bool = False
+
+
+@dataclass
+class StateGraph:
+    """Transposition table plus the command edges between unique states."""
+    nodes: dict[str, StateNode] = field(default_factory=dict)
+    edges: list[tuple[str, str, str]] = field(default_factory=list)  # (from, command, to)
+    room_names: dict[int, str] = field(default_factory=dict)
+    expanded: int = 0        # (state, command) pairs run
+    seconds: float = 0.0
+
+    @property
+    def states_per_second(self) -> float:
+        return self.expanded / self.seconds if self.seconds else 0.0
+
+    def room_graph(self) -> dict[tuple[int, int], set[str]]:
+        """Room-to-room moves: (from room, to room) -> commands that make them."""
+        rooms: dict[tuple[int, int], set[str]] = {}
+        for src, command, dst in self.edges:
+            a, b = self.nodes[src].room, self.nodes[dst].room
+            if a != b:
+                rooms.setdefault((a, b), set()).add(command)
+        return rooms
+
+    def to_dot(self) -> str:
+        """Graphviz rendering of room_graph()."""
+        lines = ["digraph rooms {"]
+        for room, name in sorted(self.room_names.items()):
+            label = (name or f"object {room}").replace('"', "'")
+            lines.append(f'  r{room} [label="{label}"];')
+        for (a, b), commands in sorted(self.room_graph().items()):
+            lines.append(f'  r{a} -> r{b} [label="{", ".join(sorted(commands))}"];')
+        lines.append("}")
+        return "\n".join(lines)
+
+
+class Explorer:
+    """Expand a frontier of states with a command set, deduplicating by hash."""
+
+    def __init__(
+        self,
+        game_path: str | Path,
+        commands: tuple[str, ...] = DEFAULT_COMMANDS,
+        num_batches: int = 6,
+        run_many: RunMany | None = None,
+        width: int | None = None,
+    ) -> None:
+        """
+        Args:
+            game_path:   Story file.
+            commands:    Commands tried from every state.
+            num_batches: Batches per command (engines.riscv.STEP_BATCHES).
+            run_many:    (states, commands) -> (texts, states). Default: zork_risc.run_sessions,
+                         headless (only the states are used).
+            width:       (state, command) pairs per run_many call. Default: zork_risc.DEVICE_SESSIONS.
+        """
+        self.game_path = Path(game_path)
+        self.story = self.game_path.read_bytes()
+        self.commands = commands
+        if run_many is None or width is None:
+            from ttlang import zork_risc  # needs ttnn: import only when used
+            if run_many is None:
+                run_many = lambda states, cmds: zork_risc.run_sessions(
+                    self.game_path, cmds, states=states, num_batches=num_batches,
+                    headless=True)
+            if width is None:
+                width = zork_risc.DEVICE_SESSIONS
+        self._run_many = run_many
+        self._width = width
+        self.graph = StateGraph()
+        self.pages = PageStore()
+
+    def _add(self, state: bytes, depth: int, path: tuple[str, ...]) -> tuple[str, bool]:
+        key = state_hash(state, self.story)
+        if key in self.graph.nodes:
+            return key, False
+        room = current_room(state, self.story)
+        if room not in self.graph.room_names:
+            self.graph.room_names[room] = object_name(state, self.story, room)
+        self.graph.nodes[key] = StateNode(key, room, depth, path, is_finished(state))
+        return key, True
+
+    def explore(
+        self,
+        start: bytes,
+        max_depth: int = 2,
+        max_states: int = 1000,
+    ) -> StateGraph:
+        """
+        Breadth-first search from start (state bytes at a READ, e.g. after the opening).
+
+        Stops at max_depth commands from start or once max_states unique states
+        are known; the frontier left at that point is simply not expanded.
+        """
+        began = time.perf_counter()
+        start_key, _ = self._add(start, 0, ())
+        states = {start_key: self.pages.put(start)}  # frontier states not fully expanded yet
+        frontier = deque([start_key])
+        cursor = 0                    # next command for frontier[0]
+
+        while True:
+            # Fill one launch with (state, command) pairs from the front of the queue
+            jobs: list[tuple[str, bytes, str]] = []
+            while frontier and len(jobs) < self._width:
+                key = frontier[0]
+                node = self.graph.nodes[key]
+                if not node.finished and node.depth < max_depth:
+                    take = self.commands[cursor:cursor + self._width - len(jobs)]
+                    state = self.pages.get(states[key])
+                    jobs.extend((key, state, c) for c in take)
+                    cursor += len(take)
+                    if cursor < len(self.commands):
+                        continue
+                frontier.popleft()
+                self.pages.release(states.pop(key))
+                cursor = 0
+            if not jobs:
+                break
+
+            _, results = self._run_many([s for _, s, _ in jobs], [c for _, _, c in jobs])
+            self.graph.expanded += len(jobs)
+            for (src, _, command), state in zip(jobs, results):
+                parent = self.graph.nodes[src]
+                dst, new = self._add(state, parent.depth + 1, parent.path + (command,))
+                self.graph.edges.append((src, command, dst))
+                if new and len(self.graph.nodes) < max_states:
+                    states[dst] = self.pages.put(state)
+                    frontier.append(dst)
+
+        self.graph.seconds += time.perf_counter() - began
+        return self.graph
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--depth", type=int, default=2, help="commands from the opening")
+    parser.add_argument("--max-states", type=int, default=1000)
+    parser.add_argument("--dot", type=Path, help="write the room graph as Graphviz")
+    args = parser.parse_args()
+
+    from ttlang.zork_risc import run_session
+    _, start = run_session(args.game, num_batches=10)
+    graph = Explorer(args.game).explore(start, args.depth, args.max_states)
+
+    print(f"{len(graph.nodes)} states, {len(graph.edges)} edges, "
+          f"{graph.expanded} expansions in {graph.seconds:.1f}s "
+          f"({graph.states_per_second:.2f} states/s)")
+    for (a, b), commands in sorted(graph.room_graph().items()):
+        print(f"  {graph.room_names.get(a, a)} --{'/'.join(sorted(commands))}--> "
+              f"{graph.room_names.get(b, b)}")
+    if args.dot:
+        args.dot.write_text(graph.to_dot() + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,316 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_fuzz.py — Snapshot-reset fuzzing of the interpreter kernel's host build.
+
+Replaying the opening for every case is too slow to fuzz the parser and the
+opcode handlers. kernels/zork_fuzz.cpp wraps the host build (zork_host.cpp) in a
+fuzz target instead. It steps the game to its first READ once and snapshots it
+there. Each case starts from the snapshot with a mutated command (input mode)
+or mutated code in the routines the seed command runs (bytecode mode). Only
+what the last case dirtied is restored: the dynamic memory pages it wrote, its
+DRAM writes (UNDO ring, SAVE slots), the registers and the live stack.
+
+After every instruction the VM is checked for a blown or underflowed stack or
+call stack and output past its buffer, and each case for a PC outside the
+story. A memory fault in the interpreter (static memory is write-protected
+while cases run) ends the case as a "fault" finding. fuzz() runs the cases in
+forked children: after a fault or a broken stack the child may be corrupted,
+so it stops and a new child forked from the snapshot carries on. If a child
+dies anyway, the case it was running is kept as a crash.
+
+Usage:
+    python ttlang/zork_fuzz.py game/zork1.z3 --seconds 10
+    python ttlang/zork_fuzz.py game/zork1.z3 --mode bytecode --budget 500 --out findings/
+"""
+from __future__ import annotations
+
+import argparse
+import ctypes
+import json
+import mmap
+import os
+import signal
+import sys
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+
+_REPO_ROOT = Path(__file__).parent.parent
+sys.path.insert(0, str(_REPO_ROOT))
+
+from ttlang import zork_native
+from ttlang.zork_state import STATE_SIZE
+
+FUZZ_SOURCE = _REPO_ROOT / "kernels" / "zork_fuzz.cpp"
+
+MODES = {"input": 0, "bytecode": 1}
+KINDS = ("ok", "stack overflow", "frame overflow", "pc outside story", "output overflow", "fault")
+CORRUPTING = (1, 2, 5)      # findings after which the process may be corrupted
+INPUT_MAX = 160
+PATCHES = 4
+KEEP = 16
+DEFAULT_BUDGET = 200        # instructions per case
+DEFAULT_SEEDS = [
+    "look", "open mailbox", "take leaflet", "read leaflet", "north", "go west",
+    "inventory", "put leaflet in mailbox", "attack troll with sword", "say hello",
+]
+
+
+class FuzzCase(ctypes.Structure):
+    _fields_ = [
+        ("length", ctypes.c_uint32),
+        ("patches", ctypes.c_uint32),
+        ("patch_addr", ctypes.c_uint32 * PATCHES),
+        ("patch_value", ctypes.c_uint8 * PATCHES),
+        ("input", ctypes.c_char * INPUT_MAX),
+    ]
+
+    @classmethod
+    def of(cls, command: str, patches: list[tuple[int, int]] = ()) -> "FuzzCase":
+        case = cls()
+        data = command.encode("ascii", errors="replace")[:INPUT_MAX]
+        case.length = len(data)
+        case.input = data
+        case.patches = len(patches)
+        for i, (addr, value) in enumerate(patches):
+            case.patch_addr[i], case.patch_value[i] = addr, value
+        return case
+
+    def describe(self) -> dict:
+        return {
+            "input": ctypes.string_at(ctypes.addressof(self) + FuzzCase.input.offset,
+                                      self.length).decode("latin-1"),
+            "patches": [[self.patch_addr[i], self.patch_value[i]] for i in range(self.patches)],
+        }
+
+
+class FuzzFinding(ctypes.Structure):
+    _fields_ = [("kind", ctypes.c_uint32), ("pc", ctypes.c_int32), ("case", FuzzCase)]
+
+
+class FuzzReport(ctypes.Structure):
+    _fields_ = [
+        ("cases", ctypes.c_uint64),
+        ("restored", ctypes.c_uint64),
+        ("findings", ctypes.c_uint64 * len(KINDS)),
+        ("kept", ctypes.c_uint32),
+        ("running", ctypes.c_uint32),
+        ("current", FuzzCase),
+        ("found", FuzzFinding * KEEP),
+    ]
+
+
+class FuzzTarget:
+    """The fuzz build of the kernel, with a story loaded and (after snapshot()) a snapshot."""
+
+    def __init__(self, game_path: str | Path, fuse: bool = False) -> None:
+        self.story = zork_native.map_story(game_path)
+        self.kernel = zork_native.NativeKernel(1, fuse, FUZZ_SOURCE)
+        lib = self._lib = self.kernel._lib
+        if lib.zork_fuzz_report_size() != ctypes.sizeof(FuzzReport):
+            raise RuntimeError("zork_fuzz: FuzzReport layout differs from kernels/zork_fuzz.cpp")
+        lib.zork_fuzz_snapshot.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+        lib.zork_fuzz_snapshot.restype = ctypes.c_int32
+        lib.zork_fuzz_run.argtypes = [ctypes.c_uint32, ctypes.c_char_p, ctypes.c_uint32,
+                                      ctypes.c_uint32, ctypes.c_uint64, ctypes.POINTER(FuzzReport)]
+        lib.zork_fuzz_run.restype = ctypes.c_bool
+        lib.zork_fuzz_replay.argtypes = [ctypes.POINTER(FuzzCase), ctypes.c_uint32,
+                                         ctypes.c_char_p, ctypes.c_uint32]
+        lib.zork_fuzz_replay.restype = ctypes.c_int32
+        lib.zork_fuzz_state.argtypes = [ctypes.c_char_p]
+        lib.zork_fuzz_state.restype = ctypes.c_bool
+
+    def _prepare(self) -> None:
+        zork_native._map_l1()
+        self.kernel._load(self.story)
+
+    def snapshot(self, state: bytes | None = None, max_instructions: int = 1_000_000) -> int:
+        """Step state (None = a new game) to its first READ and snapshot it; returns the steps."""
+        with zork_native._lock:
+            self._prepare()
+            steps = self._lib.zork_fuzz_snapshot(state, max_instructions)
+        if steps < 0:
+            raise RuntimeError("zork_fuzz: no READ before the game ended or max_instructions")
+        return steps
+
+    def state(self) -> bytes:
+        """The snapshot's state bytes (a kernel state at the READ)."""
+        buf = ctypes.create_string_buffer(STATE_SIZE)
+        if not self._lib.zork_fuzz_state(buf):
+            raise RuntimeError("zork_fuzz: no snapshot")
+        return buf.raw
+
+    def run(self, report: FuzzReport, cases: int, mode: str = "input",
+            seeds: list[str] = DEFAULT_SEEDS, budget: int = DEFAULT_BUDGET, seed: int = 1) -> None:
+        """Run cases in this process, adding to report."""
+        lines = "\n".join(s.replace("\n", " ") for s in seeds if s).encode("ascii", errors="replace")
+        with zork_native._lock:
+            self._prepare()
+            if not self._lib.zork_fuzz_run(MODES[mode], lines, cases, budget, seed, ctypes.byref(report)):
+                raise RuntimeError("zork_fuzz: no snapshot or no seeds")
+
+    def replay(self, case: FuzzCase, budget: int = DEFAULT_BUDGET) -> tuple[str, str]:
+        """Run one case from the snapshot: (output text, finding kind)."""
+        out = ctypes.create_string_buffer(zork_native.OUTPUT_SIZE)
+        with zork_native._lock:
+            self._prepare()
+            kind = self._lib.zork_fuzz_replay(ctypes.byref(case), budget, out, len(out))
+        if kind < 0:
+            raise RuntimeError("zork_fuzz: no snapshot")
+        return out.value.decode("ascii", errors="replace"), KINDS[kind]
+
+
+@dataclass
+class FuzzResult:
+    cases: int
+    seconds: float
+    restored: int
+    findings: dict[str, int]
+    kept: list[dict] = field(default_factory=list)
+    crashes: list[dict] = field(default_factory=list)
+
+    @property
+    def execs_per_second(self) -> float:
+        return self.cases / self.seconds if self.seconds else 0.0
+
+    def summary(self) -> dict:
+        return {
+            "cases": self.cases,
+            "seconds": round(self.seconds, 3),
+            "execs_per_second": round(self.execs_per_second),
+            "restored_bytes_per_case": round(self.restored / self.cases, 1) if self.cases else 0.0,
+            "findings": self.findings,
+            "crashes": len(self.crashes),
+        }
+
+
+def _crashes(target: FuzzTarget, case: FuzzCase, budget: int) -> bool:
+    """Whether case kills a fresh child forked from the snapshot."""
+    pid = os.fork()
+    if pid == 0:
+        try:
+            target.replay(case, budget)
+        finally:
+            os._exit(0)
+    _, status = os.waitpid(pid, 0)
+    return os.WIFSIGNALED(status)
+
+
+def fuzz(
+    target: FuzzTarget,
+    mode: str = "input",
+    seconds: float = 10.0,
+    cases: int | None = None,
+    seeds: list[str] = DEFAULT_SEEDS,
+    budget: int = DEFAULT_BUDGET,
+    seed: int = 1,
+    chunk: int = 10_000,
+    progress: bool = False,
+) -> FuzzResult:
+    """
+    Fuzz from target's snapshot for `seconds` (or until `cases`) in forked children.
+
+    Each child runs chunks of cases into a shared FuzzReport until time or cases
+    run out, or until a fault or a broken stack or call stack may have
+    corrupted it. A child
+    killed by a signal leaves report.running set: its current case is the crash.
+    An earlier case's stray write can be the real cause, so the crash is replayed
+    in a fresh child from the snapshot ("reproduced"). The next child continues
+    with a fresh random seed.
+    """
+    shared = mmap.mmap(-1, ctypes.sizeof(FuzzReport))
+    report = FuzzReport.from_buffer(shared)
+    crashes: list[dict] = []
+    began = time.perf_counter()
+    deadline = began + seconds
+    child_seed = seed
+
+    def done() -> bool:
+        return (cases is not None and report.cases >= cases) or \
+               (cases is None and time.perf_counter() >= deadline)
+
+    while not done():
+        pid = os.fork()
+        if pid == 0:
+            code = 0
+            try:
+                last = time.perf_counter()
+                rng = child_seed
+                while not done():
+                    corrupting = sum(report.findings[k] for k in CORRUPTING)
+                    n = chunk if cases is None else min(chunk, cases - report.cases)
+                    target.run(report, n, mode, seeds, budget, rng)
+                    rng += 1
+                    if sum(report.findings[k] for k in CORRUPTING) != corrupting:
+                        break
+                    if progress and time.perf_counter() - last >= 1.0:
+                        last = time.perf_counter()
+                        rate = report.cases / (last - began)
+                        print(f"[zork_fuzz] {report.cases} cases  {rate:,.0f}/s  "
+                              f"findings {sum(report.findings)}  crashes {len(crashes)}", flush=True)
+            except BaseException:
+                code = 1
+            finally:
+                os._exit(code)
+        _, status = os.waitpid(pid, 0)
+        child_seed += 0x10001
+        if os.WIFSIGNALED(status) and report.running:
+            case = FuzzCase.from_buffer_copy(report.current)
+            crashes.append({"signal": signal.Signals(os.WTERMSIG(status)).name,
+                            "reproduced": _crashes(target, case, budget),
+                            **case.describe()})
+            report.running = 0
+            report.cases += 1
+        elif os.WIFEXITED(status) and os.WEXITSTATUS(status) != 0:
+            raise RuntimeError("zork_fuzz: fuzzing child failed")
+        elif not os.WIFEXITED(status):
+            raise RuntimeError(f"zork_fuzz: fuzzing child died outside a case ({status})")
+
+    result = FuzzResult(
+        cases=report.cases,
+        seconds=time.perf_counter() - began,
+        restored=report.restored,
+        findings={KINDS[k]: report.findings[k] for k in range(1, len(KINDS)) if report.findings[k]},
+        kept=[{"kind": KINDS[f.kind], "pc": f.pc, **f.case.describe()}
+              for f in report.found[:report.kept]],
+        crashes=crashes,
+    )
+    del report
+    shared.close()
+    return result
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--mode", choices=tuple(MODES), default="input")
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--cases", type=int, default=None, help="stop after this many cases")
+    parser.add_argument("--budget", type=int, default=DEFAULT_BUDGET, help="instructions per case")
+    parser.add_argument("--seeds", type=Path, help="seed commands, one per line")
+    parser.add_argument("--seed", type=int, default=1, help="random seed")
+    parser.add_argument("--fuse", action="store_true", help="fuzz the ZORK_FUSE build")
+    parser.add_argument("--out", type=Path, help="write findings and crashes here as JSON")
+    args = parser.parse_args()
+
+    seeds = args.seeds.read_text().splitlines() if args.seeds else DEFAULT_SEEDS
+    target = FuzzTarget(args.game, args.fuse)
+    steps = target.snapshot()
+    print(f"[zork_fuzz] snapshot at the first READ after {steps} instructions", flush=True)
+    result = fuzz(target, args.mode, args.seconds, args.cases, seeds, args.budget, args.seed,
+                  progress=True)
+
+    summary = result.summary()
+    print(f"{summary['cases']} cases in {summary['seconds']}s = "
+          f"{summary['execs_per_second']:,} execs/s, "
+          f"{summary['restored_bytes_per_case']} B restored per case")
+    print(f"findings: {summary['findings'] or 'none'}  crashes: {summary['crashes']}")
+    if args.out:
+        args.out.mkdir(parents=True, exist_ok=True)
+        (args.out / "findings.json").write_text(json.dumps(
+            {"summary": summary, "findings": result.kept, "crashes": result.crashes}, indent=2) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,226 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_image.py — Portable, versioned session images for moving sessions.
+
+A session's state bytes are the kernel's raw ZMachineState plus its dynamic
+memory. That is all a session needs, but the format is tied to one kernel build:
+struct padding, slot position in a run_sessions() batch, a 96 KB block per
+session. A session image is the same information in a self-describing format.
+Another core, another device, or a later kernel can import it without
+replaying the game.
+
+Image format (little-endian), IMAGE_VERSION 2:
+    "ZSIM" u16 version u16 flags
+    story identity      u16 release, 6 B serial, u16 checksum (header 0x02 / 0x12 / 0x1C)
+    VM context          u32 pc (offset), u8 finished, u32 instruction_count,
+                        u16 sp + sp × u16, u16 frame_sp +
+                        frame_sp × (u32 ret_pc offset, u8 num_locals, u8 store_var, 15 × u16)
+    bookkeeping         u32 undo_head, undo_count, save_slot,
+                        4 × (u32 size, u16 release, u16 checksum), 4 × u32 verify_*,
+                        u32 ring_stage (version 2; version 1 images import with 0)
+    u32 rng             always 0: the kernel's RANDOM is deterministic
+    host context        u32 output cursor, u16 n + n × (u16 len, bytes) pending input
+    u32 n + zlib        dynamic memory
+    u32 n + zlib        UNDO ring and SAVE slots (mostly zeros; they compress to little)
+
+The kernel already stores frame return addresses and the PC as offsets into story
+memory, so no pointer relocation is needed. import_image() runs any registered
+migrations to bring an older image up to IMAGE_VERSION. It then rebuilds a
+STATE_SIZE block that upload_state() / run_sessions() accept.
+
+move_session() is the live-migration entry point. The host owns every session's
+state bytes between launches, so a session moves between two launches. It is
+exported from one run_sessions() slot list and imported into another (another
+core's or device's batch) without losing a turn.
+"""
+from __future__ import annotations
+
+import struct
+import zlib
+from dataclasses import dataclass, field
+from typing import Callable
+
+from ttlang.zork_state import (
+    FRAME_SIZE, STATE_DYN_OFFSET, STATE_FINISHED_OFFSET, STATE_FRAME_SP_OFFSET,
+    STATE_FRAMES_OFFSET, STATE_INSTRUCTION_COUNT_OFFSET, STATE_PC_OFFSET,
+    STATE_RING_OFFSET, STATE_SAVE_DIR_OFFSET, STATE_SIZE, STATE_SP_OFFSET,
+    STATE_STACK_OFFSET, STATE_STRUCT_SIZE, STATE_UNDO_HEAD_OFFSET, dynamic_size,
+)
+
+IMAGE_MAGIC = b"ZSIM"
+IMAGE_VERSION = 2
+
+# Bookkeeping fields, undo_head through ring_stage, copied as one block
+_BOOKKEEPING = slice(STATE_UNDO_HEAD_OFFSET, STATE_STRUCT_SIZE)
+
+
+class ImageError(ValueError):
+    """The image is malformed, from a newer format, or for a different story."""
+
+
+@dataclass
+class SessionImage:
+    """An imported session: kernel state bytes plus the host-side context."""
+    state: bytes
+    output_cursor: int = 0
+    pending_input: list[str] = field(default_factory=list)
+
+
+def story_identity(story: bytes) -> bytes:
+    """Release, serial and checksum: 10 bytes that name a story file."""
+    return story[0x02:0x04] + story[0x12:0x18] + story[0x1C:0x1E]
+
+
+class _Reader:
+    def __init__(self, data: bytes, pos: int) -> None:
+        self.data = data
+        self.pos = pos
+
+    def take(self, fmt: str) -> tuple:
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise ImageError("truncated session image")
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values
+
+    def blob(self) -> bytes:
+        (n,) = self.take("<I")
+        if self.pos + n > len(self.data):
+            raise ImageError("truncated session image")
+        self.pos += n
+        return self.data[self.pos - n:self.pos]
+
+
+def _bookkeeping_at(body: bytes) -> int:
+    """Offset of the bookkeeping block in an image body (after the VM context)."""
+    r = _Reader(body, 10 + struct.calcsize("<IBI"))
+    (sp,) = r.take("<H")
+    r.pos += 2 * sp
+    (frame_sp,) = r.take("<H")
+    return r.pos + frame_sp * (struct.calcsize("<IBB") + 30)
+
+
+def _v1_to_v2(body: bytes) -> bytes:
+    """Version 2 appends ZMachineState.ring_stage to the bookkeeping: RING_NONE."""
+    at = _bookkeeping_at(body) + 60   # version 1: undo_head through verify_sum
+    return body[:at] + struct.pack("<I", 0) + body[at:]
+
+
+# version -> function upgrading an image body of that version to version + 1
+MIGRATIONS: dict[int, Callable[[bytes], bytes]] = {1: _v1_to_v2}
+
+
+def export_image(
+    state: bytes,
+    story: bytes,
+    output_cursor: int = 0,
+    pending_input: list[str] | None = None,
+) -> bytes:
+    """Serialise one session's state bytes (from run_session/run_sessions)."""
+    u32 = lambda off: struct.unpack_from("<I", state, off)[0]
+    sp = u32(STATE_SP_OFFSET)
+    frame_sp = u32(STATE_FRAME_SP_OFFSET)
+
+    out = bytearray(IMAGE_MAGIC + struct.pack("<HH", IMAGE_VERSION, 0))
+    out += story_identity(story)
+    out += struct.pack("<IBI", u32(STATE_PC_OFFSET), state[STATE_FINISHED_OFFSET],
+                       u32(STATE_INSTRUCTION_COUNT_OFFSET))
+    out += struct.pack("<H", sp) + state[STATE_STACK_OFFSET:STATE_STACK_OFFSET + 2 * sp]
+    out += struct.pack("<H", frame_sp)
+    for i in range(frame_sp):
+        base = STATE_FRAMES_OFFSET + i * FRAME_SIZE
+        out += struct.pack("<IBB", u32(base), state[base + 4], state[base + 36])
+        out += state[base + 6:base + 36]
+    out += state[_BOOKKEEPING]
+    out += struct.pack("<I", 0)  # rng
+    inputs = pending_input or []
+    out += struct.pack("<IH", output_cursor, len(inputs))
+    for command in inputs:
+        data = command.encode("ascii", errors="replace")
+        out += struct.pack("<H", len(data)) + data
+    for blob in (state[STATE_DYN_OFFSET:STATE_DYN_OFFSET + dynamic_size(story)],
+                 state[STATE_RING_OFFSET:STATE_SIZE]):
+        packed = zlib.compress(bytes(blob), 6)
+        out += struct.pack("<I", len(packed)) + packed
+    return bytes(out)
+
+
+def import_image(image: bytes, story: bytes) -> SessionImage:
+    """Rebuild a STATE_SIZE state block from an image made by export_image()."""
+    if image[:4] != IMAGE_MAGIC:
+        raise ImageError("not a session image")
+    (version,) = struct.unpack_from("<H", image, 4)
+    if version > IMAGE_VERSION:
+        raise ImageError(f"session image version {version} is newer than {IMAGE_VERSION}")
+    body = image[8:]
+    while version < IMAGE_VERSION:
+        if version not in MIGRATIONS:
+            raise ImageError(f"no migration from session image version {version}")
+        body = MIGRATIONS[version](body)
+        version += 1
+
+    r = _Reader(body, 0)
+    if r.take("10s")[0] != story_identity(story):
+        raise ImageError("session image belongs to a different story")
+
+    state = bytearray(STATE_SIZE)
+    pc, finished, count = r.take("<IBI")
+    struct.pack_into("<I", state, STATE_PC_OFFSET, pc)
+    state[STATE_FINISHED_OFFSET] = finished
+    struct.pack_into("<I", state, STATE_INSTRUCTION_COUNT_OFFSET, count)
+    (sp,) = r.take("<H")
+    struct.pack_into("<I", state, STATE_SP_OFFSET, sp)
+    state[STATE_STACK_OFFSET:STATE_STACK_OFFSET + 2 * sp] = r.take(f"<{2 * sp}s")[0]
+    (frame_sp,) = r.take("<H")
+    struct.pack_into("<I", state, STATE_FRAME_SP_OFFSET, frame_sp)
+    for i in range(frame_sp):
+        base = STATE_FRAMES_OFFSET + i * FRAME_SIZE
+        ret_pc, num_locals, store_var = r.take("<IBB")
+        struct.pack_into("<IB", state, base, ret_pc, num_locals)
+        state[base + 36] = store_var
+        state[base + 6:base + 36] = r.take("<30s")[0]
+    state[_BOOKKEEPING] = r.take(f"<{_BOOKKEEPING.stop - _BOOKKEEPING.start}s")[0]
+    r.take("<I")  # rng: nothing to restore yet
+
+    output_cursor, n_inputs = r.take("<IH")
+    pending = []
+    for _ in range(n_inputs):
+        (n,) = r.take("<H")
+        pending.append(r.take(f"<{n}s")[0].decode("ascii", errors="replace"))
+
+    dyn = zlib.decompress(r.blob())
+    if len(dyn) != dynamic_size(story):
+        raise ImageError("session image dynamic memory size does not match the story")
+    state[STATE_DYN_OFFSET:STATE_DYN_OFFSET + len(dyn)] = dyn
+    ring = zlib.decompress(r.blob())
+    state[STATE_RING_OFFSET:STATE_RING_OFFSET + len(ring)] = ring
+    return SessionImage(bytes(state), output_cursor, pending)
+
+
+def move_session(
+    src: list[bytes | None],
+    index: int,
+    dst: list[bytes | None],
+    story: bytes,
+) -> int:
+    """
+    Move session src[index] into dst between launches, without replaying it.
+
+    src and dst are the per-session state lists passed to run_sessions() for two
+    different batches (cores or devices). The session is removed from src (its
+    slot becomes None, a fresh game) and takes the first free (None) slot of dst,
+    or is appended. Returns the session's index in dst.
+    """
+    state = src[index]
+    if state is None:
+        raise ValueError(f"session slot {index} is empty")
+    moved = import_image(export_image(state, story), story).state
+    src[index] = None
+    for i, slot in enumerate(dst):
+        if slot is None:
+            dst[i] = moved
+            return i
+    dst.append(moved)
+    return len(dst) - 1
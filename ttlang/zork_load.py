@@ -0,0 +1,264 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_load.py — Closed-loop load generator for the session server.
+
+Drives N simulated players against a ZorkServer (ttlang/zork_server.py). Each
+player opens a session and types a command stream. It waits for every response,
+then "thinks" before the next command, so the offered load follows the
+server's speed the way real players do.
+
+Command streams come from transcripts:
+    demos/demo-*.sh   the scripted demos: in the block piped into play.py,
+                      `sleep N` lines become think times and `echo "cmd"`
+                      lines become commands ("quit" is dropped)
+    anything else     one command per line, optionally prefixed with ">"
+
+Results:
+    - per-command latency: p50 / p95 / p99 / max, in ms, per distinct command
+      and overall
+    - throughput in commands per second
+    - batching: per distinct command, the mean and max batch size (steps that
+      shared the backend call that ran it, from each step reply); overall, the
+      server's launches per command and mean batch size
+    - --csv writes one row per command, --json writes the whole report
+
+Backends for the embedded server (--backend, see ttlang/zork_server.py): device
+(the card), host (the same kernel built for the host CPU) and python (ZMachineV3).
+
+Usage:
+    python ttlang/zork_load.py game/zork1.z3 --backend host --players 32
+    python ttlang/zork_load.py --socket /tmp/zork.sock --players 8 \\
+        --transcript demos/demo-stage1.sh --think-scale 0.1 --json load.json
+"""
+from __future__ import annotations
+
+import argparse
+import asyncio
+import contextlib
+import csv
+import json
+import re
+import sys
+import threading
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang.zork_server import DEFAULT_SOCKET, ZorkClient
+
+_ECHO = re.compile(r'^\s*echo\s+"([^"]*)"\s*$')
+_SLEEP = re.compile(r"^\s*sleep\s+([0-9.]+)")
+
+# Used when no transcript is given: the Stage 1 demo, 3 s between commands.
+DEFAULT_STREAM: list[tuple[float, str]] = [
+    (3.0, "look"), (3.0, "open mailbox"), (3.0, "take leaflet"), (5.0, "read leaflet"),
+]
+
+
+def load_transcript(path: Path) -> list[tuple[float, str]]:
+    """(think seconds, command) pairs from a demo script or a plain transcript."""
+    stream: list[tuple[float, str]] = []
+    think = 0.0
+    lines = path.read_text().splitlines()
+    if path.suffix == ".sh" and "{" in (l.strip() for l in lines):
+        # The demos pipe a `{ sleep/echo ... } | play.py` block into the game;
+        # the echo lines outside it are banners.
+        start = [l.strip() for l in lines].index("{")
+        end = next(i for i in range(start, len(lines)) if lines[i].lstrip().startswith("}"))
+        lines = lines[start + 1:end]
+    for line in lines:
+        if path.suffix == ".sh":
+            if m := _SLEEP.match(line):
+                think += float(m.group(1))
+            elif (m := _ECHO.match(line)) and m.group(1) and m.group(1) != "quit":
+                stream.append((think, m.group(1)))
+                think = 0.0
+        elif command := line.strip().lstrip(">").strip():
+            stream.append((0.0, command))
+    return stream
+
+
+def percentiles(samples: list[float]) -> dict[str, float]:
+    """p50/p95/p99/max of samples (seconds) in ms."""
+    if not samples:
+        return {"p50": 0.0, "p95": 0.0, "p99": 0.0, "max": 0.0, "n": 0}
+    s = sorted(samples)
+    at = lambda p: round(1000 * s[min(len(s) - 1, int(p * len(s)))], 3)
+    return {"p50": at(0.50), "p95": at(0.95), "p99": at(0.99), "max": at(1.0), "n": len(s)}
+
+
+def batch_sizes(sizes: list[int]) -> dict[str, float | None]:
+    """Mean and max of the batch sizes one command's steps ran in (None: not reported)."""
+    if not sizes:
+        return {"mean_batch": None, "max_batch": None}
+    return {"mean_batch": round(sum(sizes) / len(sizes), 2), "max_batch": max(sizes)}
+
+
+@dataclass
+class LoadReport:
+    players: int
+    seconds: float
+    latencies: dict[str, list[float]] = field(default_factory=dict)  # command -> seconds
+    batches: dict[str, list[int]] = field(default_factory=dict)      # command -> batch sizes
+    server: dict = field(default_factory=dict)                       # metrics delta
+    errors: int = 0
+
+    @property
+    def commands(self) -> int:
+        return sum(len(v) for v in self.latencies.values())
+
+    def summary(self) -> dict:
+        steps = self.server.get("steps", 0)
+        launches = self.server.get("launches", 0)
+        return {
+            "players": self.players,
+            "seconds": round(self.seconds, 3),
+            "commands": self.commands,
+            "errors": self.errors,
+            "commands_per_second": round(self.commands / self.seconds, 2) if self.seconds else 0.0,
+            "launches_per_command": round(launches / steps, 3) if steps else 0.0,
+            "mean_batch": round(steps / launches, 2) if launches else 0.0,
+            "latency_ms": percentiles([x for v in self.latencies.values() for x in v]),
+            "per_command": {c: {**percentiles(v), **batch_sizes(self.batches.get(c, []))}
+                            for c, v in sorted(self.latencies.items())},
+        }
+
+    def write_csv(self, path: Path) -> None:
+        with path.open("w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["command", "n", "p50_ms", "p95_ms", "p99_ms", "max_ms",
+                        "mean_batch", "max_batch"])
+            for command, p in self.summary()["per_command"].items():
+                w.writerow([command, p["n"], p["p50"], p["p95"], p["p99"], p["max"],
+                            p["mean_batch"], p["max_batch"]])
+
+
+def run_load(
+    socket_path: str,
+    players: int,
+    stream: list[tuple[float, str]],
+    rounds: int = 1,
+    think_scale: float = 1.0,
+) -> LoadReport:
+    """Play stream `rounds` times with each of `players` concurrent players."""
+    report = LoadReport(players, 0.0)
+    lock = threading.Lock()
+    probe = ZorkClient(socket_path)
+    before = probe.metrics()
+
+    def player() -> None:
+        client = ZorkClient(socket_path)
+        try:
+            t0 = time.perf_counter()
+            sid, _ = client.create()
+            samples = [("<create>", time.perf_counter() - t0, None)]
+            for _ in range(rounds):
+                for think, command in stream:
+                    time.sleep(think * think_scale)
+                    t0 = time.perf_counter()
+                    reply = client.request(op="step", session=sid, command=command)
+                    samples.append((command, time.perf_counter() - t0, reply.get("batch")))
+            client.close_session(sid)
+        except Exception:
+            with lock:
+                report.errors += 1
+            samples = []
+        finally:
+            client.close()
+        with lock:
+            for command, seconds, batch in samples:
+                report.latencies.setdefault(command, []).append(seconds)
+                if batch is not None:
+                    report.batches.setdefault(command, []).append(batch)
+
+    began = time.perf_counter()
+    threads = [threading.Thread(target=player) for _ in range(players)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    report.seconds = time.perf_counter() - began
+
+    after = probe.metrics()
+    probe.close()
+    report.server = {k: after[k] - before[k] for k in ("steps", "launches")}
+    return report
+
+
+@contextlib.contextmanager
+def embedded_server(game: Path, backend: str, socket_path: str, batches: int = 6):
+    """Run a ZorkServer in a background thread for the duration of the block."""
+    from ttlang.zork_server import ZorkServer, make_backend
+
+    server = ZorkServer(make_backend(backend, game, batches), socket_path)
+    loop = asyncio.new_event_loop()
+    ready = threading.Event()
+    stop = asyncio.Event()
+
+    async def main() -> None:
+        started = asyncio.Event()
+        task = asyncio.create_task(server.serve(started))
+        await started.wait()
+        ready.set()
+        await stop.wait()
+        task.cancel()
+        with contextlib.suppress(asyncio.CancelledError):
+            await task
+
+    thread = threading.Thread(target=lambda: loop.run_until_complete(main()), daemon=True)
+    thread.start()
+    ready.wait()
+    try:
+        yield socket_path
+    finally:
+        loop.call_soon_threadsafe(stop.set)
+        thread.join()
+        loop.close()
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, nargs="?", help="story (with --backend)")
+    parser.add_argument("--backend", choices=("device", "host", "python"),
+                        help="start an embedded server instead of using --socket")
+    parser.add_argument("--socket", default=DEFAULT_SOCKET)
+    parser.add_argument("--players", type=int, default=8)
+    parser.add_argument("--rounds", type=int, default=1, help="passes over the stream")
+    parser.add_argument("--transcript", type=Path, help="demo script or command list")
+    parser.add_argument("--think-scale", type=float, default=1.0,
+                        help="multiply transcript think times (0 = no thinking)")
+    parser.add_argument("--csv", type=Path, help="per-command latency table")
+    parser.add_argument("--json", type=Path, help="full report")
+    args = parser.parse_args()
+
+    stream = load_transcript(args.transcript) if args.transcript else DEFAULT_STREAM
+    with contextlib.ExitStack() as stack:
+        socket_path = args.socket
+        if args.backend:
+            if args.game is None:
+                parser.error("--backend needs the story file")
+            socket_path = stack.enter_context(embedded_server(args.game, args.backend, args.socket))
+        report = run_load(socket_path, args.players, stream, args.rounds, args.think_scale)
+
+    summary = report.summary()
+    lat = summary["latency_ms"]
+    print(f"{summary['players']} players, {summary['commands']} commands in "
+          f"{summary['seconds']}s = {summary['commands_per_second']} cmd/s, "
+          f"{summary['errors']} errors")
+    print(f"  latency ms: p50 {lat['p50']}  p95 {lat['p95']}  p99 {lat['p99']}  max {lat['max']}")
+    print(f"  launches/command {summary['launches_per_command']}  mean batch {summary['mean_batch']}")
+    for command, p in summary["per_command"].items():
+        batching = (f"  mean batch {p['mean_batch']}  max batch {p['max_batch']}"
+                    if p["mean_batch"] is not None else "")
+        print(f"    {command!r}: n {p['n']}  p50 {p['p50']} ms{batching}")
+    if args.csv:
+        report.write_csv(args.csv)
+    if args.json:
+        args.json.write_text(json.dumps(summary, indent=2) + "\n")
+
+
+if __name__ == "__main__":
+    main()
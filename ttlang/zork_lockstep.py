@@ -0,0 +1,214 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_lockstep.py — Many host kernel sessions per launch, stepped in SIMD lockstep.
+
+kernels/zork_lockstep.cpp wraps the host build (zork_host.cpp) in a launch for
+any number of sessions. It keeps pc, sp, frame_sp and the locals of every
+session in a structure-of-arrays register file. Sessions at the same PC run
+that instruction together: operand fetch, arithmetic, compares and branch
+targets go 8 sessions at a time in AVX2 lanes. Sessions that branch apart
+form smaller groups, and the rest of a group that does not fill 8 lanes runs
+one session at a time. A session reaching an instruction the lanes do not run
+(text output, READ, SAVE / RESTORE / VERIFY and a few edge cases) finishes its
+slice in the kernel's own interpreter. The states and text are those of one
+zork_native launch per session, byte for byte.
+
+LockstepKernel keeps the sessions' state blocks resident between launches, so
+a launch copies nothing in or out for sessions that stay in lockstep.
+run_sessions() is zork_native.run_sessions() for any number of sessions, with
+the same arguments, batches and result.
+
+Requires a C++17 compiler and an AVX2 CPU; see available().
+
+Usage (benchmark against the scalar zork_native path):
+    python ttlang/zork_lockstep.py game/zork1.z3 --sessions 256 --batches 100
+"""
+from __future__ import annotations
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+from pathlib import Path
+
+_REPO_ROOT = Path(__file__).parent.parent
+sys.path.insert(0, str(_REPO_ROOT))
+
+from ttlang import zork_native
+from ttlang.zork_state import (
+    INPUT_SIZE, MAX_SESSIONS, STATE_INSTRUCTION_COUNT_OFFSET, STATE_SIZE, input_block,
+)
+
+LOCKSTEP_SOURCE = _REPO_ROOT / "kernels" / "zork_lockstep.cpp"
+LOCKSTEP_MAX_SESSIONS = 16384   # LOCKSTEP_MAX_SESSIONS in the kernel
+
+_kernels: dict[int, "LockstepKernel"] = {}
+
+
+class LockstepStats(ctypes.Structure):
+    """Instruction and launch counters (LockstepStats in kernels/zork_lockstep.cpp)."""
+
+    _fields_ = [
+        ("sessions", ctypes.c_uint64),   # session launches
+        ("lanes", ctypes.c_uint64),      # instructions run 8 sessions at a time in AVX2 lanes
+        ("tails", ctypes.c_uint64),      # instructions run one session at a time in lockstep
+        ("kernel", ctypes.c_uint64),     # session launches finished in the kernel's interpreter
+        ("groups", ctypes.c_uint64),     # instructions decoded (one per PC group per step)
+    ]
+
+    @property
+    def lane_share(self) -> float:
+        """Share of all instructions (SLICE per session launch) run in AVX2 lanes."""
+        return self.lanes / (self.sessions * zork_native.SLICE) if self.sessions else 0.0
+
+
+def available() -> bool:
+    """True when a compiler is on PATH and the CPU has AVX2."""
+    if not zork_native.available():
+        return False
+    try:
+        return "avx2" in Path("/proc/cpuinfo").read_text().split()
+    except OSError:
+        return False
+
+
+class LockstepKernel:
+    """The lockstep build, with `sessions` state blocks resident between launches."""
+
+    def __init__(self, sessions: int) -> None:
+        if not 1 <= sessions <= LOCKSTEP_MAX_SESSIONS:
+            raise ValueError(f"LockstepKernel: need 1..{LOCKSTEP_MAX_SESSIONS} sessions, got {sessions}")
+        self.sessions = sessions
+        self.kernel = zork_native.NativeKernel(1, False, LOCKSTEP_SOURCE)
+        lib = self._lib = self.kernel._lib
+        if not lib.zork_lockstep_supported():
+            raise RuntimeError("zork_lockstep: this CPU has no AVX2")
+        if lib.zork_lockstep_stats_size() != ctypes.sizeof(LockstepStats):
+            raise RuntimeError("zork_lockstep: LockstepStats layout differs from kernels/zork_lockstep.cpp")
+        lib.zork_lockstep_launch.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p,
+                                             ctypes.c_uint32, ctypes.c_bool, ctypes.POINTER(LockstepStats)]
+        lib.zork_lockstep_launch.restype = ctypes.c_bool
+        self._inputs = (ctypes.c_uint8 * (INPUT_SIZE * sessions))()
+        self._states = (ctypes.c_uint8 * (STATE_SIZE * sessions))()
+        self._outputs = (ctypes.c_uint8 * (zork_native.OUTPUT_SIZE * sessions))()
+        self.stats = LockstepStats()
+
+    def load(self, states: list[bytes | None]) -> None:
+        """Set the sessions' states (None or missing = fresh)."""
+        ctypes.memset(self._states, 0, ctypes.sizeof(self._states))
+        for i, state in enumerate(states[:self.sessions]):
+            if state:
+                ctypes.memmove(ctypes.byref(self._states, i * STATE_SIZE), state, min(len(state), STATE_SIZE))
+
+    def states(self) -> list[bytes]:
+        """The sessions' current states."""
+        raw = bytes(self._states)
+        return [raw[i * STATE_SIZE:(i + 1) * STATE_SIZE] for i in range(self.sessions)]
+
+    def set_inputs(self, inputs: list[bytes]) -> None:
+        """The input block of each session, kept for the following launches."""
+        ctypes.memmove(self._inputs, b"".join(inputs), min(len(inputs), self.sessions) * INPUT_SIZE)
+
+    def launch(self, story: zork_native.Story, lanes: bool = True) -> list[str]:
+        """One launch of every session; returns their text. lanes=False runs each in the kernel."""
+        with zork_native._lock:
+            zork_native._map_l1()
+            self.kernel._load(story)
+            if not self._lib.zork_lockstep_launch(self._inputs, self._states, self._outputs,
+                                                  self.sessions, lanes, ctypes.byref(self.stats)):
+                raise RuntimeError("zork_lockstep: launch refused (no story loaded?)")
+        base = ctypes.addressof(self._outputs)
+        return [ctypes.string_at(base + i * zork_native.OUTPUT_SIZE).decode("ascii", errors="replace")
+                for i in range(self.sessions)]
+
+
+def kernel(sessions: int) -> LockstepKernel:
+    """The shared LockstepKernel for `sessions`."""
+    with zork_native._build_lock:
+        if sessions not in _kernels:
+            _kernels[sessions] = LockstepKernel(sessions)
+        return _kernels[sessions]
+
+
+def run_sessions(
+    game_path: str | Path,
+    commands: list[str],
+    states: list[bytes | None] | None = None,
+    num_batches: int | None = None,
+    headless: bool = False,
+    lanes: bool = True,
+) -> tuple[list[str], list[bytes]]:
+    """zork_native.run_sessions() for any number of sessions: same arguments, batches and result."""
+    game_path = Path(game_path)
+    if not game_path.exists():
+        raise FileNotFoundError(f"Game file not found: {game_path}")
+    story = zork_native.map_story(game_path)
+    k = kernel(len(commands))
+    k.load(list(states or []))
+    k.set_inputs([input_block(command, None, headless) for command in commands])
+    texts: list[list[str]] = [[] for _ in commands]
+    for _ in range(zork_native._batches(num_batches)):
+        for i, text in enumerate(k.launch(story, lanes)):
+            if text.strip():
+                texts[i].append(text)
+    return ["\n".join(t) for t in texts], k.states()
+
+
+def _instructions(states: list[bytes]) -> int:
+    return sum(int.from_bytes(s[STATE_INSTRUCTION_COUNT_OFFSET:STATE_INSTRUCTION_COUNT_OFFSET + 4], "little")
+               for s in states)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--sessions", type=int, default=256)
+    parser.add_argument("--batches", type=int, default=100, help="launches per session")
+    parser.add_argument("--opening", type=int, default=300, help="launches before the sessions split")
+    parser.add_argument("--commands", default="north,south,east,west,open mailbox,take all,look,inventory",
+                        help="comma-separated command pool the sessions pick from")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    # Every session starts from the same opening and takes its own command
+    _, start = zork_native.run_session(args.game, num_batches=args.opening)
+    pool = args.commands.split(",")
+    rng = random.Random(args.seed)
+    commands = [rng.choice(pool) for _ in range(args.sessions)]
+    before = _instructions([start] * args.sessions)
+
+    results = {}
+    began = time.perf_counter()
+    texts: list[str] = []
+    states: list[bytes] = []
+    for i in range(0, args.sessions, MAX_SESSIONS):
+        t, s = zork_native.run_sessions(args.game, commands[i:i + MAX_SESSIONS],
+                                        [start] * len(commands[i:i + MAX_SESSIONS]), args.batches)
+        texts += t
+        states += s
+    results["zork_native (scalar)"] = (time.perf_counter() - began, texts, states, None)
+    for name, lanes in (("lockstep, lanes off", False), ("lockstep", True)):
+        k = kernel(args.sessions)
+        k.stats = LockstepStats()
+        began = time.perf_counter()
+        texts, states = run_sessions(args.game, commands, [start] * args.sessions, args.batches, lanes=lanes)
+        results[name] = (time.perf_counter() - began, texts, states, k.stats)
+
+    scalar_seconds, scalar_texts, scalar_states, _ = results["zork_native (scalar)"]
+    instructions = _instructions(scalar_states) - before
+    print(f"{args.sessions} sessions x {args.batches} launches, {instructions} instructions")
+    for name, (seconds, texts, states, stats) in results.items():
+        same = texts == scalar_texts and states == scalar_states
+        line = (f"  {name:22s} {seconds:7.2f}s  {instructions / seconds:12,.0f} instr/s  "
+                f"{scalar_seconds / seconds:5.1f}x  {'identical' if same else 'DIFFERS'}")
+        if stats is not None and stats.lanes + stats.tails:
+            line += (f"  ({stats.lane_share:.0%} in AVX2 lanes, "
+                     f"{stats.tails / (stats.sessions * zork_native.SLICE):.0%} single, "
+                     f"{stats.kernel / stats.sessions:.0%} of launches in the kernel)")
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
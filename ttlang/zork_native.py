@@ -0,0 +1,400 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_native.py — The RISC-V interpreter kernel, compiled for the host CPU.
+
+kernels/zork_host.cpp wraps kernels/zork_interpreter_l1.cpp, with a host
+data-movement shim, as a shared library. This module compiles it on first use,
+the way ttnn JIT-compiles the kernel for the device. It caches the build under
+~/.cache/tt-zork (or $ZORK_NATIVE_CACHE), keyed by the sources and defines, and
+loads it with ctypes.
+
+A native launch is the device launch, run on the host: the same slices, state
+bytes and output. So run_session() / run_sessions() here are drop-in,
+hardware-free versions of the zork_risc.py functions with the same names, and
+their states are interchangeable with the device's. Use them to develop and
+test kernel changes, drive the explorer or the server without a card, or check
+a device run against a host run.
+
+NativeZMachine gives the kernel the shape of ZMachineV3 (input_command,
+interpret, flush_output, running/game_over, snapshot/restore). It is not a
+drop-in for SimEngine. The kernel's READ does not look words up in the
+dictionary, and it takes its input again at each READ within a run instead of
+pausing for the next command.
+
+The kernel places its buffers at fixed L1 addresses. The first kernel loaded
+maps that window (0x10000–0x60000) into this process, and every build shares it.
+Launches are serialised.
+
+Stories are memory-mapped read-only (map_story), once per file per process, and
+never copied: the kernel's game reads are served from the mapping. The story is
+also mapped copy-on-write over the start of the kernel's game image in L1, so
+its static memory is read straight from the page cache, shared by every session
+and every process running it. Only the pages holding dynamic memory are copied,
+on first write. A session's own memory is its state: the interpreter registers
+and its dynamic memory overlay.
+
+Requires a C++17 compiler ($CXX, default g++); see available().
+
+Usage:
+    python ttlang/zork_native.py game/zork1.z3 "open mailbox" --batches 300
+"""
+from __future__ import annotations
+
+import argparse
+import ctypes
+import hashlib
+import mmap
+import os
+import shutil
+import subprocess
+import sys
+import threading
+from pathlib import Path
+
+_REPO_ROOT = Path(__file__).parent.parent
+sys.path.insert(0, str(_REPO_ROOT))
+
+from ttlang.zork_state import (
+    HOST_CMD_SLOT, HOST_CMD_UNDO, INPUT_SIZE, MAX_SESSIONS, STATE_INSTRUCTION_COUNT_OFFSET,
+    STATE_SIZE, input_block, is_finished, ring_launched,
+)
+
+HOST_SOURCE = _REPO_ROOT / "kernels" / "zork_host.cpp"
+KERNEL_PATH = _REPO_ROOT / "kernels" / "zork_interpreter_l1.cpp"
+SHIM_DIR = _REPO_ROOT / "kernels" / "host"
+
+# Same geometry as zork_risc.py (which needs ttnn to import).
+OUTPUT_SIZE = 16 * 1024
+DEFAULT_BATCHES = 10
+SLICE = 10  # ZORK_SLICE: instructions per session per launch
+
+# The kernel's L1 window, mapped at its device addresses.
+L1_BASE = 0x10000
+L1_SIZE = 0x50000
+L1_GAME = 0x10000   # the kernel's game image
+GAME_SIZE = 87040
+
+_PROT_READ, _PROT_WRITE = 0x1, 0x2
+_MAP_SHARED, _MAP_PRIVATE, _MAP_FIXED, _MAP_ANONYMOUS = 0x01, 0x02, 0x10, 0x20
+_MAP_FIXED_NOREPLACE = 0x100000
+_MAP_FAILED = ctypes.c_void_p(-1).value
+
+_lock = threading.Lock()
+_build_lock = threading.Lock()   # builds and kernel() (threads share a pid)
+_l1_mapped = False
+_l1_story: "Story | None" = None   # story mapped at L1_GAME (None = not current)
+_l1_generation = 0
+_kernels: dict[tuple[int, bool], "NativeKernel"] = {}
+_stories: dict[tuple, "Story"] = {}
+
+
+def _cxx() -> str:
+    return os.environ.get("CXX", "g++")
+
+
+def available() -> bool:
+    """True when a compiler is on PATH to build the host kernel."""
+    return shutil.which(_cxx()) is not None
+
+
+def _cache_dir() -> Path:
+    default = Path.home() / ".cache" / "tt-zork"
+    return Path(os.environ.get("ZORK_NATIVE_CACHE", default))
+
+
+def build(sessions: int = 1, fuse: bool = False, source: Path = HOST_SOURCE) -> Path:
+    """Compile the host kernel for `sessions` sessions; returns the cached .so.
+
+    source is zork_host.cpp or a file that includes it (kernels/zork_fuzz.cpp).
+    """
+    flags = ["-O2", "-std=c++17", "-shared", "-fPIC", f"-I{SHIM_DIR}",
+             f"-DZORK_SESSIONS={sessions}"] + (["-DZORK_FUSE=1"] if fuse else [])
+    h = hashlib.blake2b(digest_size=8)
+    for path in dict.fromkeys((source, HOST_SOURCE, KERNEL_PATH,
+                               SHIM_DIR / "api" / "dataflow" / "dataflow_api.h")):
+        h.update(path.read_bytes())
+    h.update(" ".join([_cxx()] + flags).encode())
+    lib = _cache_dir() / f"{source.stem}_{h.hexdigest()}.so"
+    if not lib.exists():
+        lib.parent.mkdir(parents=True, exist_ok=True)
+        tmp = lib.with_suffix(f".{os.getpid()}.{threading.get_ident()}.tmp")
+        result = subprocess.run([_cxx(), *flags, str(source), "-o", str(tmp)],
+                                capture_output=True, text=True)
+        if result.returncode != 0:
+            tmp.unlink(missing_ok=True)
+            raise RuntimeError(f"zork_native: host kernel build failed:\n{result.stderr}")
+        tmp.replace(lib)
+    return lib
+
+
+def _mmap(addr: int | None, length: int, prot: int, flags: int, fd: int = -1) -> int:
+    libc = ctypes.CDLL(None, use_errno=True)
+    libc.mmap.restype = ctypes.c_void_p
+    libc.mmap.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_int,
+                          ctypes.c_int, ctypes.c_int, ctypes.c_long]
+    result = libc.mmap(addr, length, prot, flags, fd, 0)
+    if result in (None, _MAP_FAILED) or (addr is not None and result != addr):
+        where = f" at {addr:#x}" if addr is not None else ""
+        raise OSError(ctypes.get_errno(), f"zork_native: mmap of {length} B{where} failed")
+    return result
+
+
+def _map_l1() -> None:
+    """Reserve the kernel's L1 addresses in this process (once)."""
+    global _l1_mapped
+    if _l1_mapped:
+        return
+    _mmap(L1_BASE, L1_SIZE, _PROT_READ | _PROT_WRITE,
+          _MAP_PRIVATE | _MAP_ANONYMOUS | _MAP_FIXED_NOREPLACE)
+    _l1_mapped = True
+
+
+class Story:
+    """A story file mapped read-only; see map_story()."""
+
+    def __init__(self, path: Path) -> None:
+        self.path = path
+        self._fd = os.open(path, os.O_RDONLY)
+        self.size = os.fstat(self._fd).st_size
+        if self.size == 0:
+            os.close(self._fd)
+            raise ValueError(f"zork_native: empty story file {path}")
+        self.address = _mmap(None, self.size, _PROT_READ, _MAP_SHARED, self._fd)
+        self.l1_length = 0   # bytes mapped at L1_GAME by place_in_l1()
+
+    def read(self) -> bytes:
+        """A copy of the story bytes."""
+        return ctypes.string_at(self.address, self.size)
+
+    def place_in_l1(self) -> int:
+        """Map the story copy-on-write over L1_GAME; returns the bytes mapped."""
+        window = GAME_SIZE // mmap.PAGESIZE * mmap.PAGESIZE
+        length = min(-(-self.size // mmap.PAGESIZE) * mmap.PAGESIZE, window)
+        # Clear what an earlier story mapped, then map this one's pages
+        _mmap(L1_GAME, window, _PROT_READ | _PROT_WRITE, _MAP_PRIVATE | _MAP_ANONYMOUS | _MAP_FIXED)
+        _mmap(L1_GAME, length, _PROT_READ | _PROT_WRITE, _MAP_PRIVATE | _MAP_FIXED, self._fd)
+        return length
+
+
+def map_story(game_path: str | Path) -> Story:
+    """The process's mapping of game_path (remapped if the file has changed)."""
+    path = Path(game_path).resolve()
+    st = path.stat()
+    key = (path, st.st_ino, st.st_size, st.st_mtime_ns)
+    with _lock:
+        if key not in _stories:
+            _stories[key] = Story(path)
+        return _stories[key]
+
+
+def _story_in_l1(story: Story) -> tuple[int, int]:
+    """Make story the one mapped at L1_GAME; (bytes mapped, mapping generation)."""
+    global _l1_story, _l1_generation
+    if _l1_story is not story:
+        story.l1_length = story.place_in_l1()
+        _l1_story = story
+        _l1_generation += 1
+    return story.l1_length, _l1_generation
+
+
+def _decode_output(raw: bytes) -> str:
+    end = raw.find(b"\x00")
+    return (raw[:end] if end >= 0 else raw).decode("ascii", errors="replace")
+
+
+class NativeKernel:
+    """One loaded host build: `sessions` time-sliced sessions per launch."""
+
+    def __init__(self, sessions: int = 1, fuse: bool = False, source: Path = HOST_SOURCE) -> None:
+        if not 1 <= sessions <= MAX_SESSIONS:
+            raise ValueError(f"NativeKernel: need 1..{MAX_SESSIONS} sessions, got {sessions}")
+        self.sessions = sessions
+        self._lib = ctypes.CDLL(str(build(sessions, fuse, source)))
+        self._lib.zork_host_load.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+        self._lib.zork_host_launch.argtypes = [ctypes.c_char_p, ctypes.c_void_p, ctypes.c_void_p]
+        self._story: Story | bytes | None = None
+        self._generation = 0
+        self._states = (ctypes.c_uint8 * (STATE_SIZE * sessions))()
+        self._outputs = (ctypes.c_uint8 * (OUTPUT_SIZE * sessions))()
+
+    def _load(self, story: Story | bytes) -> None:
+        """Point the kernel's game window at story (no copy)."""
+        global _l1_story
+        if isinstance(story, Story):
+            in_l1, generation = _story_in_l1(story)
+            if story is not self._story or generation != self._generation:
+                self._lib.zork_host_load(story.address, story.size, in_l1)
+            self._generation = generation
+        else:
+            _l1_story = None   # the kernel will overwrite the whole game image
+            if story is not self._story:
+                self._lib.zork_host_load(story, len(story), 0)
+        self._story = story
+
+    def launch(self, story: Story | bytes, inputs: list[bytes], states: list[bytes | None]) -> tuple[list[str], list[bytes]]:
+        """One launch over `sessions` input blocks and states (None = fresh)."""
+        with _lock:
+            _map_l1()
+            self._load(story)
+            ctypes.memset(self._states, 0, ctypes.sizeof(self._states))
+            for i, state in enumerate(states):
+                if state:
+                    n = min(len(state), STATE_SIZE)
+                    ctypes.memmove(ctypes.byref(self._states, i * STATE_SIZE), state, n)
+            self._lib.zork_host_launch(b"".join(inputs), self._states, self._outputs)
+            raw_states = bytes(self._states)
+            raw_out = bytes(self._outputs)
+        return (
+            [_decode_output(raw_out[i * OUTPUT_SIZE:(i + 1) * OUTPUT_SIZE]) for i in range(self.sessions)],
+            [raw_states[i * STATE_SIZE:(i + 1) * STATE_SIZE] for i in range(self.sessions)],
+        )
+
+
+def kernel(sessions: int = 1) -> NativeKernel:
+    """The shared NativeKernel for `sessions` (ZORK_FUSE=1 in the environment fuses)."""
+    key = (sessions, os.environ.get("ZORK_FUSE", "") == "1")
+    with _build_lock:
+        if key not in _kernels:
+            _kernels[key] = NativeKernel(*key)
+        return _kernels[key]
+
+
+def _batches(num_batches: int | None) -> int:
+    if num_batches is None:
+        env_batches = os.environ.get("ZORK_BATCHES", "")
+        return int(env_batches) if env_batches.isdigit() else DEFAULT_BATCHES
+    return num_batches
+
+
+def run_session(
+    game_path: str | Path,
+    state: bytes | None = None,
+    command: str = "",
+    verbose: bool = False,
+    num_batches: int | None = None,
+    undo: int = 0,
+    save_slot: int | None = None,
+    headless: bool = False,
+) -> tuple[str, bytes | None]:
+    """zork_risc.run_session() on the host: same arguments, batches and result."""
+    game_path = Path(game_path)
+    if not game_path.exists():
+        raise FileNotFoundError(f"Game file not found: {game_path}")
+    story = map_story(game_path)
+    num_batches = _batches(num_batches)
+    k = kernel(1)
+
+    saved_state = state
+    all_text: list[str] = []
+    seen_output = False
+    for batch in range(num_batches):
+        host_cmd = None
+        if undo and batch == 0:
+            host_cmd = (HOST_CMD_UNDO, undo)
+        elif save_slot is not None and batch == (1 if undo else 0):
+            host_cmd = (HOST_CMD_SLOT, save_slot)
+        texts, states = k.launch(story, [input_block(command, host_cmd, headless)], [saved_state])
+        batch_text, saved_state = texts[0], states[0]
+        all_text.append(batch_text)
+        if batch_text.strip():
+            seen_output = True
+        if undo and batch == 0:
+            continue
+        if verbose:
+            print(f"[zork_native] batch {batch + 1}/{num_batches}: "
+                  f"{len(batch_text.strip())} chars", flush=True)
+        if seen_output and not batch_text.strip() and not ring_launched(saved_state):
+            break
+
+    return "\n".join(t for t in all_text if t.strip()), saved_state
+
+
+def run_sessions(
+    game_path: str | Path,
+    commands: list[str],
+    states: list[bytes | None] | None = None,
+    num_batches: int | None = None,
+    headless: bool = False,
+) -> tuple[list[str], list[bytes]]:
+    """zork_risc.run_sessions() on the host: same arguments, batches and result."""
+    game_path = Path(game_path)
+    if not game_path.exists():
+        raise FileNotFoundError(f"Game file not found: {game_path}")
+    n = len(commands)
+    if not 1 <= n <= MAX_SESSIONS:
+        raise ValueError(f"run_sessions: need 1..{MAX_SESSIONS} sessions, got {n}")
+    story = map_story(game_path)
+    k = kernel(n)
+
+    inputs = [input_block(command, None, headless) for command in commands]
+    current: list[bytes | None] = list(states or []) + [None] * (n - len(states or []))
+    texts: list[list[str]] = [[] for _ in range(n)]
+    for _ in range(_batches(num_batches)):
+        outs, current = k.launch(story, inputs, current)
+        for i, text in enumerate(outs):
+            if text.strip():
+                texts[i].append(text)
+    return ["\n".join(t) for t in texts], current
+
+
+class NativeZMachine:
+    """The host kernel behind a ZMachineV3-like interface (see the module docstring)."""
+
+    def __init__(self, game_bytes: bytes) -> None:
+        self.story = bytes(game_bytes)
+        self.state: bytes | None = None
+        self.input_command = ""
+        self._output: list[str] = []
+        self._kernel = kernel(1)
+
+    @property
+    def instruction_count(self) -> int:
+        return int.from_bytes(self.state[STATE_INSTRUCTION_COUNT_OFFSET:STATE_INSTRUCTION_COUNT_OFFSET + 4], "little") if self.state else 0
+
+    @property
+    def game_over(self) -> bool:
+        return self.state is not None and is_finished(self.state)
+
+    @property
+    def running(self) -> bool:
+        return not self.game_over
+
+    def interpret(self, max_instructions: int = 100) -> None:
+        """Run max_instructions, rounded up to whole SLICE-instruction launches."""
+        block = input_block(self.input_command, None)
+        for _ in range(-(-max_instructions // SLICE)):
+            if self.game_over:
+                break
+            texts, states = self._kernel.launch(self.story, [block], [self.state])
+            self._output.append(texts[0])
+            self.state = states[0]
+
+    def flush_output(self) -> str:
+        text = "".join(self._output)
+        self._output.clear()
+        return text
+
+    def snapshot(self) -> bytes:
+        """The kernel state bytes (zork_image.export_image() makes them portable)."""
+        return self.state or bytes(STATE_SIZE)
+
+    def restore(self, state: bytes) -> None:
+        self.state = bytes(state)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("command", nargs="?", default="", help="input for each READ")
+    parser.add_argument("--batches", type=int, default=None, help="10-instruction launches")
+    args = parser.parse_args()
+
+    text, state = run_session(args.game, command=args.command, num_batches=args.batches)
+    print(text)
+    count = int.from_bytes(state[STATE_INSTRUCTION_COUNT_OFFSET:STATE_INSTRUCTION_COUNT_OFFSET + 4], "little") if state else 0
+    print(f"[zork_native] {count} instructions", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_pages.py — Content-addressed page store for kernel session states.
+
+Host tools keep many copies of the kernel's state bytes: explorer frontiers,
+speculation caches, golden snapshots. Each copy is STATE_SIZE (96 KB). Two states
+differ in a handful of dynamic-memory pages, and the UNDO ring and SAVE slots are
+mostly zeros, so nearly all pages repeat across states.
+
+PageStore splits a state into PAGE_SIZE pages and hashes each page. It keeps
+each distinct page once, in a reference-counted pool. A stored state is the
+vector of its page hashes. get() puts the pages back together in the kernel's
+state layout, ready for upload_state()/run_sessions(). Memory per stored state
+drops to the handful of pages unique to it plus a 16-byte hash per page.
+
+The pool lives in host memory only. A DRAM-resident pool would need a gather
+step on the device before the kernel reads its state, so it is left out.
+"""
+from __future__ import annotations
+
+import hashlib
+from dataclasses import dataclass
+
+PAGE_SIZE = 512  # bytes; divides STATE_SIZE and the 4 KB / 8 KB ring and slot records
+
+
+@dataclass(frozen=True)
+class StateRef:
+    """Handle to a state in a PageStore."""
+    pages: tuple[bytes, ...]  # page hashes, in order
+    size: int                 # state length in bytes
+
+
+class PageStore:
+    """Reference-counted pool of deduplicated state pages."""
+
+    def __init__(self, page_size: int = PAGE_SIZE) -> None:
+        self.page_size = page_size
+        self._pool: dict[bytes, bytes] = {}
+        self._refs: dict[bytes, int] = {}
+        self.states = 0          # live StateRefs
+        self.logical_bytes = 0   # what the live states would take stored flat
+
+    def put(self, state: bytes) -> StateRef:
+        """Store state; every put() needs a matching release()."""
+        hashes = []
+        for off in range(0, len(state), self.page_size):
+            page = bytes(state[off:off + self.page_size])
+            h = hashlib.blake2b(page, digest_size=16).digest()
+            if h in self._refs:
+                self._refs[h] += 1
+            else:
+                self._pool[h] = page
+                self._refs[h] = 1
+            hashes.append(h)
+        self.states += 1
+        self.logical_bytes += len(state)
+        return StateRef(tuple(hashes), len(state))
+
+    def get(self, ref: StateRef) -> bytes:
+        """The stored state's bytes, in the kernel's state layout."""
+        return b"".join(self._pool[h] for h in ref.pages)
+
+    def release(self, ref: StateRef) -> None:
+        """Drop one reference to each page of ref; unreferenced pages are freed."""
+        for h in ref.pages:
+            n = self._refs[h] - 1
+            if n:
+                self._refs[h] = n
+            else:
+                del self._refs[h]
+                del self._pool[h]
+        self.states -= 1
+        self.logical_bytes -= ref.size
+
+    @property
+    def pool_pages(self) -> int:
+        return len(self._pool)
+
+    @property
+    def stored_bytes(self) -> int:
+        """Bytes held: pool pages plus the per-state hash vectors."""
+        pages = sum(len(p) for p in self._pool.values())
+        return pages + 16 * sum(self._refs.values())
+
+    @property
+    def ratio(self) -> float:
+        """logical_bytes / stored_bytes — how many times smaller than flat copies."""
+        stored = self.stored_bytes
+        return self.logical_bytes / stored if stored else 1.0
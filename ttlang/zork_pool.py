@@ -0,0 +1,265 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_pool.py — Work-stealing executor for many host kernel sessions.
+
+Offline workloads (regression scripts, exploration, bot load) don't need the
+device. They run on the host build of the kernel (ttlang/zork_native.py) much
+more cheaply, with the same states a device run would have. SessionPool runs
+thousands of scripted sessions over a pool of workers:
+
+    - Each worker owns a deque of sessions. New sessions are dealt round-robin.
+    - A worker takes the next session from the right of its own deque and runs
+      one slice: zork_native launches until the next READ (the session's next
+      command goes in the input block of its next slice) or `budget` instructions.
+    - A session that yields re-enters at the left of the same worker's deque.
+      That worker sees it again after its other sessions (round-robin).
+    - A worker whose deque is empty steals from the left of the fullest deque:
+      the session its owner would reach last, usually the one that just
+      yielded. Owner and thief work opposite ends of a deque.
+
+Each worker is a single-process executor, so the pool scales across every core
+of the machine. Each worker process loads one zork_native.kernel(1) and maps
+the story once (_init_worker). With processes=False it is a thread per worker,
+which is handy in tests; the threads share one kernel, and launches are
+serialised. A slice ships the session's state to the worker as a session image
+(zork_image: registers, stack, frames and compressed memory, a few KB rather
+than the 96 KB state block). It returns the new image and only that slice's
+text; the coordinator keeps each Session's output, so it never crosses the
+process boundary again.
+
+run() returns a PoolReport with per-session and aggregate instructions/second.
+
+Usage:
+    python ttlang/zork_pool.py game/zork1.z3 --sessions 1000 --workers 32
+"""
+from __future__ import annotations
+
+import argparse
+import os
+import sys
+import threading
+import time
+from collections import deque
+from concurrent.futures import Executor, ProcessPoolExecutor, ThreadPoolExecutor
+from dataclasses import dataclass, field
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang import zork_native
+from ttlang.zork_image import export_image, import_image
+from ttlang.zork_state import (
+    STATE_INSTRUCTION_COUNT_OFFSET, input_block, is_finished, waiting_for_input,
+)
+
+# Instructions per slice when a session doesn't reach READ first.
+DEFAULT_BUDGET = 50_000
+
+# Default script: the opening moves of Zork I.
+DEFAULT_SCRIPT = (
+    "open mailbox", "read leaflet", "north", "east", "open window", "enter",
+    "take all", "west", "move rug", "open trapdoor", "turn on lamp", "down",
+)
+
+# Per worker process: the story mapping, its bytes (for images) and the kernel
+_STORY: zork_native.Story | None = None
+_STORY_BYTES: bytes = b""
+_KERNEL: zork_native.NativeKernel | None = None
+
+
+def _init_worker(game_path: str) -> None:
+    global _STORY, _STORY_BYTES, _KERNEL
+    _STORY = zork_native.map_story(game_path)
+    _STORY_BYTES = _STORY.read()
+    _KERNEL = zork_native.kernel(1)
+
+
+@dataclass
+class Session:
+    """One scripted game: the commands it will type and what it has done so far."""
+    id: int
+    script: tuple[str, ...]
+    image: bytes | None = None   # zork_image session image; None before the first slice
+    reading: bool = False        # the last slice stopped at a READ
+    turn: int = 0                # commands consumed
+    output: list[str] = field(default_factory=list)
+    instructions: int = 0
+    seconds: float = 0.0         # time spent inside slices
+    slices: int = 0
+    steals: int = 0
+    done: bool = False
+
+    @property
+    def instructions_per_second(self) -> float:
+        return self.instructions / self.seconds if self.seconds else 0.0
+
+
+@dataclass
+class Slice:
+    """What run_slice() sends back: the new image and this slice's text only."""
+    image: bytes
+    text: str
+    instructions: int
+    seconds: float
+    reading: bool                # stopped at a READ: the next slice types a command
+    finished: bool               # the game has ended (QUIT)
+
+
+@dataclass
+class PoolReport:
+    sessions: list[Session]
+    seconds: float               # wall time of run()
+    workers: int
+
+    @property
+    def instructions(self) -> int:
+        return sum(s.instructions for s in self.sessions)
+
+    @property
+    def instructions_per_second(self) -> float:
+        return self.instructions / self.seconds if self.seconds else 0.0
+
+    @property
+    def steals(self) -> int:
+        return sum(s.steals for s in self.sessions)
+
+
+def _count(state: bytes) -> int:
+    return int.from_bytes(state[STATE_INSTRUCTION_COUNT_OFFSET:STATE_INSTRUCTION_COUNT_OFFSET + 4], "little")
+
+
+def run_slice(image: bytes | None, command: str, budget: int) -> Slice:
+    """Launch from image to the next READ or by budget instructions (runs in a worker)."""
+    began = time.perf_counter()
+    state = None if image is None else import_image(image, _STORY_BYTES).state
+    before = _count(state) if state else 0
+    block = input_block(command)
+    texts = []
+    while True:
+        (text,), (state,) = _KERNEL.launch(_STORY, [block], [state])
+        texts.append(text)
+        if is_finished(state) or waiting_for_input(state) or _count(state) - before >= budget:
+            break
+    return Slice(export_image(state, _STORY_BYTES), "".join(texts), _count(state) - before,
+                 time.perf_counter() - began, waiting_for_input(state), is_finished(state))
+
+
+def _advance(session: Session, budget: int) -> tuple[bytes | None, str, int]:
+    """run_slice() arguments for session's next slice; types its next command at a READ."""
+    command = ""
+    if session.reading:
+        command = session.script[session.turn]
+        session.turn += 1
+    return session.image, command, budget
+
+
+def _record(session: Session, result: Slice) -> None:
+    session.image = result.image
+    session.output.append(result.text)
+    session.instructions += result.instructions
+    session.seconds += result.seconds
+    session.slices += 1
+    session.reading = result.reading
+    session.done = result.finished or (result.reading and session.turn >= len(session.script))
+    if session.done:
+        session.image = None
+
+
+class SessionPool:
+    """Per-worker deques with work stealing over host kernel sessions."""
+
+    def __init__(
+        self,
+        game_path: str | Path,
+        workers: int | None = None,
+        budget: int = DEFAULT_BUDGET,
+        processes: bool = True,
+    ) -> None:
+        self.game_path = str(Path(game_path).resolve())
+        # Build the host kernel once here rather than in every worker at once
+        zork_native.build(1, os.environ.get("ZORK_FUSE", "") == "1")
+        self.workers = workers or os.cpu_count() or 1
+        self.budget = budget
+        self.processes = processes
+        self._deques: list[deque[Session]] = [deque() for _ in range(self.workers)]
+        self._lock = threading.Condition()
+        self._in_flight = 0
+        self._finished: list[Session] = []
+
+    def _executor(self) -> Executor:
+        if self.processes:
+            return ProcessPoolExecutor(1, initializer=_init_worker, initargs=(self.game_path,))
+        _init_worker(self.game_path)
+        return ThreadPoolExecutor(1)
+
+    def _next(self, me: int) -> Session | None:
+        """Own work first, then steal; None once every session is done."""
+        with self._lock:
+            while True:
+                own = self._deques[me]
+                if own:
+                    self._in_flight += 1
+                    return own.pop()
+                victim = max(self._deques, key=len)
+                if victim:
+                    self._in_flight += 1
+                    session = victim.popleft()
+                    session.steals += 1
+                    return session
+                if self._in_flight == 0:
+                    self._lock.notify_all()
+                    return None
+                self._lock.wait()  # a running slice may yield work back
+
+    def _worker(self, me: int) -> None:
+        with self._executor() as executor:
+            while (session := self._next(me)) is not None:
+                try:
+                    _record(session, executor.submit(run_slice, *_advance(session, self.budget)).result())
+                finally:
+                    with self._lock:
+                        self._in_flight -= 1
+                        if not session.done:
+                            self._deques[me].appendleft(session)
+                        self._lock.notify_all()
+                if session.done:
+                    self._finished.append(session)
+
+    def run(self, scripts: list[tuple[str, ...]]) -> PoolReport:
+        """Play every script to its end (or the game's) and report throughput."""
+        for i, script in enumerate(scripts):
+            self._deques[i % self.workers].append(Session(i, tuple(script)))
+        self._finished = []
+        began = time.perf_counter()
+        threads = [threading.Thread(target=self._worker, args=(w,)) for w in range(self.workers)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        sessions = sorted(self._finished, key=lambda s: s.id)
+        return PoolReport(sessions, time.perf_counter() - began, self.workers)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--sessions", type=int, default=64)
+    parser.add_argument("--workers", type=int, default=os.cpu_count())
+    parser.add_argument("--budget", type=int, default=DEFAULT_BUDGET,
+                        help="instructions per slice")
+    args = parser.parse_args()
+
+    pool = SessionPool(args.game, args.workers, args.budget)
+    report = pool.run([DEFAULT_SCRIPT] * args.sessions)
+    rates = sorted(s.instructions_per_second for s in report.sessions)
+    print(f"{len(report.sessions)} sessions on {report.workers} workers: "
+          f"{report.instructions} instructions in {report.seconds:.2f}s "
+          f"= {report.instructions_per_second:,.0f} instr/s, {report.steals} steals")
+    if rates:
+        print(f"  per session: min {rates[0]:,.0f}  median {rates[len(rates) // 2]:,.0f}  "
+              f"max {rates[-1]:,.0f} instr/s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,288 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_ring.py — Lock-free single-producer/single-consumer rings to the runner.
+
+A host that fronts the kernel for many clients moves commands in and outputs
+out. The runner should never wait on a client's lock between launches. Each
+client gets a Channel to the runner, in shared memory, so clients can be threads
+or other processes:
+
+    commands  SpscRing  client -> runner   (session id, command bytes)
+    results   SpscRing  runner -> client   (session id, output span)
+    free      SpscRing  client -> runner   (output buffers handed back)
+    pool      OutputPool                   (the output buffers themselves)
+
+Every ring has exactly one writer per index. head is written only by the
+consumer and tail only by the producer. Each index sits on its own 64-byte line,
+so the two sides never share a cache line. A record is written in full before
+the producer publishes the new tail, and read in full before the consumer
+publishes the new head. No lock is taken. The publish order relies on in-order
+stores: CPython executes the stores in program order, and x86-64 keeps that
+order across cores and processes. Weakly ordered hosts would need a fence here.
+
+Output is not copied through the rings. The runner writes a session's text into
+a free pool buffer and sends (buffer, length). The client reads it in place
+(Span.view) and hands the buffer back with release(). A buffer is in use from
+the runner's write until that release.
+
+RingRunner is the runner side. It polls every channel and takes up to
+backend.width commands, one per session. It runs them in one backend.run_many()
+call (the ZorkServer backends: HostBackend, DeviceBackend), and publishes each
+output span. Launches go back to back while commands are waiting.
+"""
+from __future__ import annotations
+
+import struct
+import threading
+import time
+from dataclasses import dataclass
+from multiprocessing import resource_tracker, shared_memory
+from typing import Any
+
+CACHE_LINE = 64
+OUTPUT_SIZE = 16 * 1024   # one buffer: the kernel's per-session output size
+
+_U64 = struct.Struct("<Q")
+_RECORD = struct.Struct("<II")           # tag (session id), payload length
+_SPAN = struct.Struct("<II")             # buffer index, text length
+_HEAD, _TAIL, _META = 0, CACHE_LINE, 2 * CACHE_LINE
+_SLOTS = 3 * CACHE_LINE                  # records start on their own line
+
+
+def _attach(name: str) -> shared_memory.SharedMemory:
+    shm = shared_memory.SharedMemory(name=name)
+    # The creator owns the segment; don't let this process's tracker unlink it.
+    resource_tracker.unregister(shm._name, "shared_memory")  # type: ignore[attr-defined]
+    return shm
+
+
+class SpscRing:
+    """Bounded ring of (tag, payload) records for one producer and one consumer."""
+
+    def __init__(self, slots: int = 64, record_size: int = 256, name: str | None = None) -> None:
+        if name is None:
+            if slots & (slots - 1):
+                raise ValueError("SpscRing: slots must be a power of two")
+            size = _SLOTS + slots * record_size
+            self._shm = shared_memory.SharedMemory(create=True, size=size)
+            self._owner = True
+            struct.pack_into("<II", self._shm.buf, _META, slots, record_size)
+        else:
+            self._shm = _attach(name)
+            self._owner = False
+            slots, record_size = struct.unpack_from("<II", self._shm.buf, _META)
+        self.slots = slots
+        self.record_size = record_size
+        self._mask = slots - 1
+        self._buf = self._shm.buf
+
+    @property
+    def name(self) -> str:
+        return self._shm.name
+
+    @property
+    def capacity(self) -> int:
+        """Largest payload a record can carry."""
+        return self.record_size - _RECORD.size
+
+    def _index(self, off: int) -> int:
+        return _U64.unpack_from(self._buf, off)[0]
+
+    def __len__(self) -> int:
+        return self._index(_TAIL) - self._index(_HEAD)
+
+    def push(self, tag: int, payload: bytes) -> bool:
+        """Producer: enqueue a record; False when the ring is full."""
+        if len(payload) > self.capacity:
+            raise ValueError(f"SpscRing: payload of {len(payload)} B exceeds {self.capacity} B")
+        tail = self._index(_TAIL)
+        if tail - self._index(_HEAD) == self.slots:
+            return False
+        off = _SLOTS + (tail & self._mask) * self.record_size
+        _RECORD.pack_into(self._buf, off, tag, len(payload))
+        self._buf[off + _RECORD.size:off + _RECORD.size + len(payload)] = payload
+        _U64.pack_into(self._buf, _TAIL, tail + 1)       # publish
+        return True
+
+    def pop(self) -> tuple[int, bytes] | None:
+        """Consumer: dequeue the oldest record; None when the ring is empty."""
+        head = self._index(_HEAD)
+        if head == self._index(_TAIL):
+            return None
+        off = _SLOTS + (head & self._mask) * self.record_size
+        tag, n = _RECORD.unpack_from(self._buf, off)
+        payload = bytes(self._buf[off + _RECORD.size:off + _RECORD.size + n])
+        _U64.pack_into(self._buf, _HEAD, head + 1)       # hand the slot back
+        return tag, payload
+
+    def close(self) -> None:
+        self._buf = None
+        self._shm.close()
+        if self._owner:
+            self._shm.unlink()
+
+
+class OutputPool:
+    """count fixed-size output buffers in shared memory."""
+
+    def __init__(self, count: int = 16, size: int = OUTPUT_SIZE, name: str | None = None) -> None:
+        if name is None:
+            self._shm = shared_memory.SharedMemory(create=True, size=CACHE_LINE + count * size)
+            self._owner = True
+            struct.pack_into("<II", self._shm.buf, 0, count, size)
+        else:
+            self._shm = _attach(name)
+            self._owner = False
+            count, size = struct.unpack_from("<II", self._shm.buf, 0)
+        self.count = count
+        self.size = size
+
+    @property
+    def name(self) -> str:
+        return self._shm.name
+
+    def view(self, index: int, length: int = -1) -> memoryview:
+        off = CACHE_LINE + index * self.size
+        return self._shm.buf[off:off + (self.size if length < 0 else length)]
+
+    def close(self) -> None:
+        """Release every Span from this pool first; their views pin the mapping."""
+        if self._owner:
+            self._shm.unlink()
+        self._shm.close()
+
+
+@dataclass
+class Span:
+    """A session's output, in place in the channel's pool until released."""
+    session: int
+    buffer: int
+    length: int
+    view: memoryview
+
+    def text(self) -> str:
+        return bytes(self.view).decode("ascii", errors="replace")
+
+
+class Channel:
+    """One client's rings and output pool. The creator owns the shared memory."""
+
+    def __init__(self, slots: int = 64, buffers: int = 16, names: dict[str, str] | None = None) -> None:
+        names = names or {}
+        self.commands = SpscRing(slots, 1024, names.get("commands"))
+        self.results = SpscRing(slots, CACHE_LINE, names.get("results"))
+        self.free = SpscRing(max(slots, _pow2(buffers)), CACHE_LINE, names.get("free"))
+        self.pool = OutputPool(buffers, OUTPUT_SIZE, names.get("pool"))
+        # Runner side: buffers it may write into (all of them, at first)
+        self._idle = list(range(self.pool.count))
+
+    @property
+    def names(self) -> dict[str, str]:
+        """Pass to Channel(names=...) in another process to attach to this channel."""
+        return {"commands": self.commands.name, "results": self.results.name,
+                "free": self.free.name, "pool": self.pool.name}
+
+    # -- client side -------------------------------------------------------
+
+    def send(self, session: int, command: str) -> bool:
+        return self.commands.push(session, command.encode("ascii", errors="replace"))
+
+    def receive(self) -> Span | None:
+        record = self.results.pop()
+        if record is None:
+            return None
+        session, payload = record
+        buffer, length = _SPAN.unpack(payload)
+        return Span(session, buffer, length, self.pool.view(buffer, length))
+
+    def release(self, span: Span) -> None:
+        span.view.release()
+        while not self.free.push(span.buffer, b""):
+            time.sleep(0)  # ring sized for every buffer: only a slow runner fills it
+
+    # -- runner side -------------------------------------------------------
+
+    def reclaim(self) -> int:
+        """Buffers the runner may write into, after taking back released ones."""
+        while (record := self.free.pop()) is not None:
+            self._idle.append(record[0])
+        return len(self._idle)
+
+    def publish(self, session: int, text: str) -> None:
+        buffer = self._idle.pop()
+        data = text.encode("ascii", errors="replace")[:self.pool.size]
+        self.pool.view(buffer, len(data))[:] = data
+        if not self.results.push(session, _SPAN.pack(buffer, len(data))):
+            raise RuntimeError("Channel: result ring full")  # excluded by gather()
+
+    def close(self) -> None:
+        for part in (self.commands, self.results, self.free, self.pool):
+            part.close()
+
+
+def _pow2(n: int) -> int:
+    return 1 << max(0, n - 1).bit_length()
+
+
+class RingRunner:
+    """Drain every channel's commands into back-to-back backend launches."""
+
+    def __init__(self, backend: Any, channels: list[Channel], idle_sleep: float = 50e-6) -> None:
+        self.backend = backend
+        self.channels = channels
+        self.idle_sleep = idle_sleep
+        self.sessions: dict[tuple[int, int], Any] = {}
+        self._held: list[tuple[int, int, str]] = []   # popped, waiting for their session's turn
+        self.launches = 0
+        self.steps = 0
+
+    def gather(self) -> list[tuple[int, int, str]]:
+        """Up to backend.width (channel, session, command), one per session."""
+        batch: list[tuple[int, int, str]] = []
+        seen: set[tuple[int, int]] = set()
+        held, self._held = self._held, []
+        for item in held:
+            if (item[0], item[1]) in seen or len(batch) >= self.backend.width:
+                self._held.append(item)
+            else:
+                seen.add((item[0], item[1]))
+                batch.append(item)
+        for c, channel in enumerate(self.channels):
+            # Each output needs a free buffer and a result slot before it is taken
+            room = min(channel.reclaim(), channel.results.slots - len(channel.results))
+            room -= sum(1 for b in batch if b[0] == c) + sum(1 for h in self._held if h[0] == c)
+            while room > 0 and len(batch) < self.backend.width:
+                record = channel.commands.pop()
+                if record is None:
+                    break
+                session, payload = record
+                item = (c, session, payload.decode("ascii", errors="replace"))
+                room -= 1
+                if (c, session) in seen:
+                    self._held.append(item)
+                else:
+                    seen.add((c, session))
+                    batch.append(item)
+        return batch
+
+    def step(self) -> int:
+        """One launch over whatever is waiting; returns the steps it ran."""
+        batch = self.gather()
+        if not batch:
+            return 0
+        keys = [(c, s) for c, s, _ in batch]
+        states = [self.sessions[k] if k in self.sessions else self.backend.new_state() for k in keys]
+        texts, states = self.backend.run_many(states, [command for _, _, command in batch])
+        self.launches += 1
+        for key, text, state in zip(keys, texts, states):
+            self.sessions[key] = state
+            self.channels[key[0]].publish(key[1], text)
+        self.steps += len(batch)
+        return len(batch)
+
+    def run(self, stop: threading.Event) -> None:
+        """Serve until stop is set."""
+        while not stop.is_set():
+            if not self.step():
+                time.sleep(self.idle_sleep)
@@ -21,17 +21,20 @@ Batched execution — per-batch device sessions:
     session ALWAYS hangs, regardless of instruction count or state content. Confirmed
     by diag_batch3.py: even batch 3 with fresh state (IC=0) hangs.
 
-    Workaround: open and close the ttnn device for EACH batch. The Z-machine
-    state (PC, stack, call frames, dynamic game memory) is serialised to
-    host-side bytes between sessions via download_state() / upload_state():
-
-        Batch 1: open_device → fresh state → interpret(10) → download_state → close_device
-        Batch 2: open_device → upload_state → interpret(10) → download_state → close_device
-        Batch 3: open_device → upload_state → interpret(10) → download_state → close_device
+    Workaround: close and reopen the ttnn device before its third launch. The
+    Z-machine state (PC, stack, call frames, dynamic game memory) stays resident
+    in the device's DeviceBuffers (game, input, output and state tensors) for
+    the launches of one device session, and crosses to the host only when
+    DeviceSession recycles the device:
+
+        open_device → DeviceBuffers (story, fresh state) → batch 1 → batch 2
+            → read_states → close_device
+        open_device → DeviceBuffers (states) → batch 3 → batch 4 → read_states → close_device
         …
 
-    Each batch is the first (and only) kernel invocation in its device session.
     10 batches × 10 instructions = 100 total — sufficient for the Zork opening text.
+    On firmware without the hang, ZORK_KEEP_DEVICE=1 runs every batch of a call
+    in one device session.
 
 Key design decisions vs zork_on_blackhole.cpp:
     1. Flat ROW_MAJOR 1D tensors — the interpreter uses noc_async_read(0, 0, addr+offset)
@@ -66,6 +69,13 @@ Usage:
     # Run with more batches (default is 10):
     ZORK_BATCHES=15 python ttlang/zork_risc.py game/zork1.z3
 
+    # Build the kernel with superinstruction fusion (see ttlang/opcode_pairs.py):
+    ZORK_FUSE=1 python ttlang/zork_risc.py game/zork1.z3
+
+    # Keep one device session (and resident state buffers) for all batches —
+    # only on firmware without the third-generic_op hang:
+    ZORK_KEEP_DEVICE=1 python ttlang/zork_risc.py game/zork1.z3
+
 This file lives at: ttlang/zork_risc.py
 L1-resident kernel: kernels/zork_interpreter_l1.cpp  (derived from zork_interpreter_opt.cpp)
 Reference kernel:   kernels/zork_interpreter_opt.cpp  (DO NOT MODIFY — reference code)
@@ -85,6 +95,11 @@ sys.path.insert(0, str(_REPO_ROOT))
 import torch
 import ttnn
 
+from ttlang.zork_state import (
+    HOST_CMD_OFFSET, HOST_CMD_SLOT, HOST_CMD_UNDO, HOST_FLAG_HEADLESS, INPUT_SIZE, MAX_SESSIONS,
+    STATE_RING_OFFSET, STATE_SIZE, STATE_UNDO_COUNT_OFFSET, input_block, ring_due, ring_launched,
+)
+
 # ---------------------------------------------------------------------------
 # Paths and buffer geometry
 # ---------------------------------------------------------------------------
@@ -114,8 +129,8 @@ GAME_PAD: int = 87040
 # Output buffer: 16 KB = 16384 bytes. The interpreter writes text here via L1_OUT.
 OUTPUT_SIZE: int = 16 * 1024  # 16384
 
-# Input buffer: 1 KB = 1024 bytes for the user command string (null-terminated).
-INPUT_SIZE: int = 1024
+# Input buffer: INPUT_SIZE (1 KB) per session, the command string plus the host
+# command block (HOST_CMD_*, HOST_FLAG_*); zork_state.input_block() builds one.
 
 # State buffer: holds the ZMachineState struct between kernel invocations.
 # struct ZMachineState {
@@ -125,10 +140,36 @@ INPUT_SIZE: int = 1024
 #     bool     finished;                     // 1 byte
 #     uint32_t out_pos, instruction_count;   // 8 bytes (not actually used for out_pos)
 # };
-# Total: ~4630 bytes for the struct. After 32-byte alignment, dynamic game memory
-# (11282 bytes for Zork 1.z3) is appended at DYN_OFFSET. Total ~16434 bytes.
-# We allocate 32 KB to accommodate struct + dynamic memory with room to spare.
-STATE_SIZE: int = 32 * 1024  # 32768 bytes
+# Total: ~4640 bytes for the struct. After 32-byte alignment, dynamic game memory
+# (11282 bytes for Zork 1.z3) is appended at DYN_OFFSET. Total ~16434 bytes, in a
+# 32 KB area. The kernel's UNDO ring (8 × 4 KB snapshot records, written at each
+# READ) follows at UNDO_RING_OFFSET, then the SAVE slots (4 × 8 KB) at
+# SAVE_SLOTS_OFFSET, for STATE_SIZE (96 KB) in all. zork_state has the field offsets.
+UNDO_RING_OFFSET: int = STATE_RING_OFFSET
+UNDO_LEVELS: int = 8
+SAVE_SLOTS_OFFSET: int = 64 * 1024
+SAVE_SLOTS: int = 4
+
+# DeviceBuffers keeps each session's UNDO ring and SAVE slots (the last 64 KB of
+# its state bytes) in a tensor of its own, passed to the kernel as RING_DRAM_ADDR.
+# The kernel only touches them in ring launches (zork_state.ring_due), so every
+# other launch moves just the first UNDO_RING_OFFSET bytes of state each way.
+RING_SIZE: int = STATE_SIZE - UNDO_RING_OFFSET
+
+# Time-sliced sessions: with ZORK_SESSIONS=N the kernel runs N independent games
+# per launch, one ZORK_SLICE-instruction slice each, sharing the story image in L1.
+# Session i owns bytes [i*STATE_SIZE, (i+1)*STATE_SIZE) of the state tensor,
+# [i*INPUT_SIZE, ...) of the input tensor and [i*OUTPUT_SIZE, ...) of the raw
+# output bytes. The layout holds MAX_SESSIONS (zork_state), but only one
+# interpret(10) and one state round-trip per launch is known to fit the QB2
+# watchdog (see the budget notes in kernel_main). Device launches therefore run
+# one session until more are validated on hardware; ZORK_DEVICE_SESSIONS=N
+# (up to MAX_SESSIONS) raises the limit for that validation.
+DEVICE_SESSIONS: int = min(MAX_SESSIONS, max(1, int(os.environ.get("ZORK_DEVICE_SESSIONS", "1"))))
+
+# The third generic_op in one device session hangs (see the module docstring), so
+# DeviceSession recycles the device after this many launches.
+LAUNCHES_PER_OPEN: int = 2
 
 # Default number of batches for run_zork_batched().
 # 10 batches × 10 instructions = 100 total — enough for the Zork opening text
@@ -177,17 +218,8 @@ def load_game(game_path: str | Path, device: ttnn.Device) -> ttnn.Tensor:
     Returns:
         ttnn.Tensor on device DRAM, shape (GAME_PAD,), dtype uint8, ROW_MAJOR.
     """
-    game_bytes = Path(game_path).read_bytes()
-    # Verify Z-machine version byte (header byte 0 must be 3 for V3 games)
-    assert game_bytes[0] == 3, f"Expected Z-machine V3, got version {game_bytes[0]}"
-    assert len(game_bytes) >= 8, "Game file too small (need at least header bytes)"
-
-    # Zero-pad to GAME_PAD bytes so the tensor fills the full buffer
-    padded = bytearray(game_bytes[:GAME_SIZE])
-    padded += b"\x00" * (GAME_PAD - len(padded))
-
     # Keep as uint8 — 1 byte per game byte, no float conversion
-    t = torch.frombuffer(bytes(padded), dtype=torch.uint8).clone()
+    t = torch.frombuffer(_game_image(game_path), dtype=torch.uint8).clone()
     assert t.shape[0] == GAME_PAD, f"Expected {GAME_PAD} elements, got {t.shape[0]}"
 
     return ttnn.from_torch(
@@ -199,7 +231,20 @@ def load_game(game_path: str | Path, device: ttnn.Device) -> ttnn.Tensor:
     )
 
 
-def make_output(device: ttnn.Device) -> ttnn.Tensor:
+def _game_image(game_path: str | Path) -> bytes:
+    """The story zero-padded (or cut) to GAME_PAD bytes, the game buffer's size."""
+    game_bytes = Path(game_path).read_bytes()
+    # Verify Z-machine version byte (header byte 0 must be 3 for V3 games)
+    assert game_bytes[0] == 3, f"Expected Z-machine V3, got version {game_bytes[0]}"
+    assert len(game_bytes) >= 8, "Game file too small (need at least header bytes)"
+
+    # Zero-pad to GAME_PAD bytes so the tensor fills the full buffer
+    padded = bytearray(game_bytes[:GAME_SIZE])
+    padded += b"\x00" * (GAME_PAD - len(padded))
+    return bytes(padded)
+
+
+def make_output(device: ttnn.Device, sessions: int = 1) -> ttnn.Tensor:
     """
     Allocate a zero-filled 16 KB output buffer on device DRAM.
 
@@ -207,12 +252,13 @@ def make_output(device: ttnn.Device) -> ttnn.Tensor:
     NoC-writes it back to OUTPUT_DRAM_ADDR. This tensor receives that data.
 
     Args:
-        device: Open ttnn.Device.
+        device:   Open ttnn.Device.
+        sessions: Number of time-sliced sessions sharing the buffer (see MAX_SESSIONS).
 
     Returns:
-        ttnn.Tensor on device DRAM, shape (OUTPUT_SIZE,), dtype bfloat16, ROW_MAJOR.
+        ttnn.Tensor on device DRAM, shape (OUTPUT_SIZE * sessions,), dtype bfloat16, ROW_MAJOR.
     """
-    t = torch.zeros(OUTPUT_SIZE, dtype=torch.float32)
+    t = torch.zeros(OUTPUT_SIZE * sessions, dtype=torch.float32)
     return ttnn.from_torch(
         t,
         dtype=ttnn.bfloat16,
@@ -222,7 +268,12 @@ def make_output(device: ttnn.Device) -> ttnn.Tensor:
     )
 
 
-def make_input(device: ttnn.Device, command: str = "") -> ttnn.Tensor:
+def make_input(
+    device: ttnn.Device,
+    command: str = "",
+    host_cmd: tuple[int, int] | None = None,
+    headless: bool = False,
+) -> ttnn.Tensor:
     """
     Allocate a 1 KB input buffer on device DRAM and populate it with a command.
 
@@ -232,18 +283,39 @@ def make_input(device: ttnn.Device, command: str = "") -> ttnn.Tensor:
     matching what noc_async_read delivers to the kernel's input buffer.
 
     Args:
-        device:  Open ttnn.Device.
-        command: Zork command string (e.g., "open mailbox"). Empty = no input.
+        device:   Open ttnn.Device.
+        command:  Zork command string (e.g., "open mailbox"). Empty = no input.
+        host_cmd: Optional (op, arg) for the host command block at HOST_CMD_OFFSET,
+                  e.g. (HOST_CMD_UNDO, 1). The kernel acts on it at batch start.
+        headless: Set HOST_FLAG_HEADLESS: the batch writes print events, not text.
 
     Returns:
         ttnn.Tensor on device DRAM, shape (INPUT_SIZE,), dtype uint8, ROW_MAJOR.
     """
-    buf = bytearray(INPUT_SIZE)  # zero-filled (null-terminated empty string)
-    if command:
-        # Write command as null-terminated ASCII, truncated to buffer size - 1
-        cmd_bytes = command.encode("ascii", errors="replace")[:INPUT_SIZE - 1]
-        buf[:len(cmd_bytes)] = cmd_bytes
-    t = torch.frombuffer(bytes(buf), dtype=torch.uint8).clone()
+    t = torch.frombuffer(input_block(command, host_cmd, headless), dtype=torch.uint8).clone()
+    return ttnn.from_torch(
+        t,
+        dtype=ttnn.uint8,
+        layout=ttnn.ROW_MAJOR_LAYOUT,
+        device=device,
+        memory_config=ttnn.DRAM_MEMORY_CONFIG,
+    )
+
+
+def make_session_inputs(device: ttnn.Device, commands: list[str], headless: bool = False) -> ttnn.Tensor:
+    """
+    Allocate one input block per time-sliced session, packed INPUT_SIZE apart.
+
+    Args:
+        device:   Open ttnn.Device.
+        commands: One command string per session (session i reads commands[i]).
+        headless: Set HOST_FLAG_HEADLESS for every session.
+
+    Returns:
+        ttnn.Tensor on device DRAM, shape (INPUT_SIZE * len(commands),), dtype uint8.
+    """
+    buf = b"".join(input_block(command, None, headless) for command in commands)
+    t = torch.frombuffer(buf, dtype=torch.uint8).clone()
     return ttnn.from_torch(
         t,
         dtype=ttnn.uint8,
@@ -253,9 +325,9 @@ def make_input(device: ttnn.Device, command: str = "") -> ttnn.Tensor:
     )
 
 
-def make_state(device: ttnn.Device) -> ttnn.Tensor:
+def make_state(device: ttnn.Device, sessions: int = 1, size: int = STATE_SIZE) -> ttnn.Tensor:
     """
-    Allocate a zero-filled 16 KB state buffer on device DRAM.
+    Allocate a zero-filled 96 KB state buffer on device DRAM.
 
     The interpreter kernel's ZMachineState struct (~4.6 KB of actual data) is saved
     here between batches so the Python host can run multiple kernel invocations
@@ -274,17 +346,20 @@ def make_state(device: ttnn.Device) -> ttnn.Tensor:
         noc_async_write/noc_async_read), but uint8 avoids confusion and matches
         the dtype of the game and input buffers.
 
-        Crucially, uint8 with STATE_SIZE = 16384 gives exactly 16384 bytes of
-        DRAM storage — enough for sizeof(ZMachineState) ≈ 4632 bytes.
+        Crucially, uint8 with STATE_SIZE = 98304 gives exactly 98304 bytes of
+        DRAM storage — the struct, dynamic memory, the UNDO ring and save slots.
 
     Args:
-        device: Open ttnn.Device.
+        device:   Open ttnn.Device.
+        sessions: Number of time-sliced sessions, `size` bytes each.
+        size:     Bytes per session: STATE_SIZE, or UNDO_RING_OFFSET when the ring
+                  and SAVE slots get a tensor of their own (make_ring()).
 
     Returns:
-        ttnn.Tensor on device DRAM, shape (STATE_SIZE,), dtype uint8, ROW_MAJOR.
+        ttnn.Tensor on device DRAM, shape (size * sessions,), dtype uint8, ROW_MAJOR.
         Initially all zeros (instruction_count == 0 → fresh init on first batch).
     """
-    t = torch.zeros(STATE_SIZE, dtype=torch.uint8)
+    t = torch.zeros(size * sessions, dtype=torch.uint8)
     return ttnn.from_torch(
         t,
         dtype=ttnn.uint8,
@@ -294,6 +369,20 @@ def make_state(device: ttnn.Device) -> ttnn.Tensor:
     )
 
 
+def make_ring(device: ttnn.Device, sessions: int = 1) -> ttnn.Tensor:
+    """
+    Allocate the UNDO ring / SAVE slot buffer (RING_SIZE per session) without
+    filling it: nothing crosses to the device until a ring launch needs it.
+    """
+    return ttnn.allocate_tensor_on_device(
+        ttnn.Shape([RING_SIZE * sessions]),
+        ttnn.uint8,
+        ttnn.ROW_MAJOR_LAYOUT,
+        device,
+        ttnn.DRAM_MEMORY_CONFIG,
+    )
+
+
 def read_output(output_t: ttnn.Tensor) -> str:
     """
     Extract the text string from the output tensor.
@@ -318,8 +407,27 @@ def read_output(output_t: ttnn.Tensor) -> str:
     Returns:
         Decoded ASCII string containing the game's output text.
     """
+    return _decode_output(_output_bytes(output_t))
+
+
+def read_session_outputs(output_t: ttnn.Tensor, sessions: int) -> list[str]:
+    """
+    Split a time-sliced run's output tensor into one string per session.
+
+    Each session's text starts OUTPUT_SIZE raw bytes after the previous one's.
+    """
+    raw = _output_bytes(output_t)
+    return [_decode_output(raw[i * OUTPUT_SIZE:(i + 1) * OUTPUT_SIZE]) for i in range(sessions)]
+
+
+def _output_bytes(output_t: ttnn.Tensor) -> bytes:
+    """Raw bytes the kernel wrote to the (bfloat16-typed) output tensor."""
     t_bf16 = ttnn.to_torch(output_t).to(torch.bfloat16)
-    raw = bytes(t_bf16.view(torch.uint8).numpy())
+    return bytes(t_bf16.view(torch.uint8).numpy())
+
+
+def _decode_output(raw: bytes) -> str:
+    """Text up to the kernel's NUL terminator."""
     end = raw.find(b"\x00")
     if end >= 0:
         raw = raw[:end]
@@ -352,7 +460,7 @@ def download_state(state_t: ttnn.Tensor) -> bytes:
     return bytes(t_host.numpy().tobytes())   # raw bytes, no reinterpretation
 
 
-def upload_state(device: ttnn.Device, state_bytes: bytes) -> ttnn.Tensor:
+def upload_state(device: ttnn.Device, state_bytes: bytes, sessions: int = 1) -> ttnn.Tensor:
     """
     Create a pre-populated state tensor from host-side bytes and upload to device DRAM.
 
@@ -363,14 +471,16 @@ def upload_state(device: ttnn.Device, state_bytes: bytes) -> ttnn.Tensor:
     Args:
         device:      Open ttnn.Device.
         state_bytes: Bytes returned by download_state() from the previous batch.
+        sessions:    Number of time-sliced sessions, STATE_SIZE bytes each.
 
     Returns:
-        ttnn.Tensor on device DRAM, shape (STATE_SIZE,), dtype uint8, ROW_MAJOR,
+        ttnn.Tensor on device DRAM, shape (STATE_SIZE * sessions,), dtype uint8, ROW_MAJOR,
         pre-populated with the saved interpreter state.
     """
     # Pad or trim to STATE_SIZE to ensure exact tensor shape
-    buf = bytearray(STATE_SIZE)
-    n = min(len(state_bytes), STATE_SIZE)
+    size = STATE_SIZE * sessions
+    buf = bytearray(size)
+    n = min(len(state_bytes), size)
     buf[:n] = state_bytes[:n]
     t = torch.frombuffer(bytes(buf), dtype=torch.uint8).clone()
     return ttnn.from_torch(
@@ -382,6 +492,209 @@ def upload_state(device: ttnn.Device, state_bytes: bytes) -> ttnn.Tensor:
     )
 
 
+def undo_depth(state_bytes: bytes | None) -> int:
+    """
+    Number of turns the kernel's UNDO ring can currently roll back.
+
+    Args:
+        state_bytes: Bytes returned by download_state(), or None for no session.
+
+    Returns:
+        ZMachineState.undo_count (0..UNDO_LEVELS); 0 when there is no state yet.
+    """
+    if not state_bytes:
+        return 0
+    off = STATE_UNDO_COUNT_OFFSET
+    return int.from_bytes(state_bytes[off:off + 4], "little")
+
+
+# ---------------------------------------------------------------------------
+# Persistent buffers
+# ---------------------------------------------------------------------------
+
+def _host_uint8(data: bytes) -> ttnn.Tensor:
+    """A host-side uint8 tensor to copy into an existing device buffer."""
+    t = torch.frombuffer(bytearray(data), dtype=torch.uint8).clone()
+    return ttnn.from_torch(t, dtype=ttnn.uint8, layout=ttnn.ROW_MAJOR_LAYOUT)
+
+
+class DeviceBuffers:
+    """
+    The kernel's game, input, output and state buffers, allocated once per device.
+
+    make_output() / make_input() / make_state() / upload_state() allocate a new
+    tensor for every batch. DeviceBuffers allocates one slab of each for
+    `sessions` slots when the device opens. Each launch then refills the slabs in
+    place (ttnn.copy_host_to_device_tensor). The kernel's *_DRAM_ADDR defines
+    stay the same for every launch on the device, so the JIT-compiled kernel
+    binary is built once and then comes from the cache.
+
+    Session slot i is bytes [i * UNDO_RING_OFFSET, (i + 1) * UNDO_RING_OFFSET)
+    of the state slab and [i * RING_SIZE, (i + 1) * RING_SIZE) of the ring slab
+    (the rest of its STATE_SIZE state bytes), and likewise for input and output.
+    The kernel adds those offsets itself (ZORK_SESSIONS). acquire() / release()
+    hand out and recycle slots for sessions that stay resident between launches
+    (ZORK_KEEP_DEVICE).
+
+    The state slab stays on the device between launches; at most its 32 KB per
+    slot is read back before a launch to tell whether that launch may read the
+    ring slab (a ring launch or an UNDO). The ring slab is uploaded only then
+    and downloaded only after a launch that may have written it, so a batch
+    normally moves 32 KB of state, not 96 KB each way.
+    """
+
+    def __init__(self, device: ttnn.Device, sessions: int = 1) -> None:
+        self.device = device
+        self.sessions = sessions
+        self.game_t: ttnn.Tensor | None = None
+        self._game: bytes | None = None
+        self.input_t = make_session_inputs(device, [""] * sessions)
+        self.output_t = make_output(device, sessions)
+        self.state_t = make_state(device, sessions, UNDO_RING_OFFSET)
+        self.ring_t = make_ring(device, sessions)
+        self._inputs: list[bytes] = [input_block("", None)] * sessions
+        self._free = list(range(sessions - 1, -1, -1))
+        # Host copy of each slot's ring bytes, and which side is current:
+        # "host" (ring_t is stale), "same", or "device" (a launch may have written it)
+        self._rings: list[bytes] = [bytes(RING_SIZE)] * sessions
+        self._ring_current = "host"
+        # The states in state_t as last written or read, None after a launch
+        self._states: list[bytes] | None = [bytes(UNDO_RING_OFFSET)] * sessions
+
+    def acquire(self) -> int:
+        """A free session slot (lowest first)."""
+        if not self._free:
+            raise RuntimeError(f"DeviceBuffers: all {self.sessions} slots in use")
+        return self._free.pop()
+
+    def release(self, slot: int) -> None:
+        self._free.append(slot)
+        self._free.sort(reverse=True)
+
+    def load_game(self, game_path: str | Path) -> None:
+        """Put the story in the game slab; a no-op when it is already there."""
+        image = _game_image(game_path)
+        if self.game_t is None:
+            self.game_t = load_game(game_path, self.device)
+        elif image != self._game:
+            ttnn.copy_host_to_device_tensor(_host_uint8(image), self.game_t)
+        self._game = image
+
+    def write_inputs(self, blocks: list[bytes]) -> None:
+        """One INPUT_SIZE block per slot (see zork_state.input_block); unchanged inputs are skipped."""
+        blocks = blocks + [input_block("", None)] * (self.sessions - len(blocks))
+        if blocks != self._inputs:
+            ttnn.copy_host_to_device_tensor(_host_uint8(b"".join(blocks)), self.input_t)
+            self._inputs = blocks
+
+    def write_states(self, states: list[bytes | None]) -> None:
+        """Per-slot state bytes; None (or a missing entry) starts a fresh game."""
+        blocks = [bytes(state or b"")[:STATE_SIZE].ljust(STATE_SIZE, b"\0")
+                  for state in states[:self.sessions]]
+        blocks += [bytes(STATE_SIZE)] * (self.sessions - len(blocks))
+        self._states = [b[:UNDO_RING_OFFSET] for b in blocks]
+        self._rings = [b[UNDO_RING_OFFSET:] for b in blocks]
+        self._ring_current = "host"
+        ttnn.copy_host_to_device_tensor(_host_uint8(b"".join(self._states)), self.state_t)
+
+    def read_states(self) -> list[bytes]:
+        raw = download_state(self.state_t)
+        self._states = [raw[i * UNDO_RING_OFFSET:(i + 1) * UNDO_RING_OFFSET] for i in range(self.sessions)]
+        if self._ring_current == "device":
+            raw = download_state(self.ring_t)
+            self._rings = [raw[i * RING_SIZE:(i + 1) * RING_SIZE] for i in range(self.sessions)]
+            self._ring_current = "same"
+        return [state + ring for state, ring in zip(self._states, self._rings)]
+
+    def read_outputs(self) -> list[str]:
+        return read_session_outputs(self.output_t, self.sessions)
+
+    def _ring_needed(self) -> bool:
+        """True when the next launch may read or write the ring slab."""
+        if self._states is None:
+            # Reading 32 KB of state beats a 64 KB ring round trip on a guess
+            self.read_states()
+        undo = HOST_CMD_UNDO.to_bytes(4, "little")
+        return (any(ring_due(state) for state in self._states) or
+                any(block[HOST_CMD_OFFSET:HOST_CMD_OFFSET + 4] == undo for block in self._inputs))
+
+    def launch(self) -> None:
+        """One kernel launch over every slot."""
+        if self._ring_current == "host" and self._ring_needed():
+            ttnn.copy_host_to_device_tensor(_host_uint8(b"".join(self._rings)), self.ring_t)
+            self._ring_current = "same"
+        run_interpreter(self.game_t, self.output_t, self.input_t, self.device,
+                        state_t=self.state_t, sessions=self.sessions, ring_t=self.ring_t)
+        if self._ring_current != "host":
+            self._ring_current = "device"
+        self._states = None
+
+
+def _launches_per_open() -> int | None:
+    """
+    Launches one device session runs before DeviceSession recycles it.
+
+    LAUNCHES_PER_OPEN by default. ZORK_KEEP_DEVICE=1 (firmware without the
+    third-generic_op hang) lifts the limit: every batch of a call then runs in
+    one device session.
+    """
+    return None if os.environ.get("ZORK_KEEP_DEVICE", "") == "1" else LAUNCHES_PER_OPEN
+
+
+class DeviceSession:
+    """
+    The device and its DeviceBuffers for the batches of one run_session() or
+    run_sessions() call.
+
+    buffers() hands out the same DeviceBuffers, states resident on the device,
+    until _launches_per_open() launches have run on it. The next call reads the
+    states back, closes the device, and opens it again with a new DeviceBuffers
+    loaded with the story and those states. Call buffers() once per launch.
+    """
+
+    def __init__(self, game_path: str | Path, sessions: int, states: list[bytes | None]) -> None:
+        self.game_path = game_path
+        self.sessions = sessions
+        self.limit = _launches_per_open()
+        self.opens = 0
+        self._states = states
+        self._device: ttnn.Device | None = None
+        self._bufs: DeviceBuffers | None = None
+        self._launches = 0
+
+    def __enter__(self) -> DeviceSession:
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self._close()
+
+    def buffers(self) -> DeviceBuffers:
+        """The DeviceBuffers for the next launch, reopening the device when due."""
+        if self._bufs is not None and self.limit is not None and self._launches >= self.limit:
+            self._states = self._bufs.read_states()
+            self._close()
+        if self._bufs is None:
+            self._device = ttnn.open_device(device_id=0)
+            self.opens += 1
+            self._bufs = DeviceBuffers(self._device, self.sessions)
+            self._bufs.load_game(self.game_path)
+            self._bufs.write_states(self._states)
+            self._launches = 0
+        self._launches += 1
+        return self._bufs
+
+    def states(self) -> list[bytes]:
+        """Every session's state bytes as of the last launch."""
+        if self._bufs is not None:
+            self._states = self._bufs.read_states()
+        return list(self._states)
+
+    def _close(self) -> None:
+        if self._device is not None:
+            ttnn.close_device(self._device)
+        self._device = self._bufs = None
+
+
 # ---------------------------------------------------------------------------
 # Core runner
 # ---------------------------------------------------------------------------
@@ -392,6 +705,8 @@ def run_interpreter(
     input_t: ttnn.Tensor,
     device: ttnn.Device,
     state_t: ttnn.Tensor | None = None,
+    sessions: int = 1,
+    ring_t: ttnn.Tensor | None = None,
 ) -> None:
     """
     Execute kernels/zork_interpreter_l1.cpp on QB2 RISC-V via ttnn.generic_op.
@@ -415,6 +730,14 @@ def run_interpreter(
         INPUT_DRAM_ADDR  — Physical DRAM address of input tensor buffer
         STATE_DRAM_ADDR  — (optional) Physical DRAM address of state tensor buffer;
                            presence enables batched/resumable execution mode
+        RING_DRAM_ADDR   — (with ring_t) Physical DRAM address of the UNDO ring /
+                           SAVE slot tensor; the state tensor then holds only the
+                           first UNDO_RING_OFFSET bytes of each session's state
+        ZORK_FUSE        — (optional, ZORK_FUSE=1 in the environment) compile in the
+                           fused handlers for hot stack-through opcode pairs
+        ZORK_SESSIONS    — (when sessions > 1) number of time-sliced sessions; the
+                           buffers must come from make_output/make_state(sessions)
+                           and make_session_inputs()
 
     The kernel uses plain noc_async_read(get_noc_addr(0, 0, addr+offset), L1_dst, size)
     for data loading — it does NOT use TensorAccessors or CBs. This requires flat,
@@ -432,6 +755,9 @@ def run_interpreter(
                   When provided, the kernel persists ZMachineState (PC + stack + call
                   frames) between invocations. Pass the SAME tensor object to all
                   batches — the kernel overwrites it with updated state after each run.
+        sessions: Time-sliced sessions per launch (requires state_t), 1..MAX_SESSIONS.
+        ring_t:   Ring tensor (from make_ring()) to go with a state_t from
+                  make_state(size=UNDO_RING_OFFSET); None keeps the ring in state_t.
     """
     # Collect DRAM buffer addresses — these become preprocessor #defines
     game_addr   = game_t.buffer_address()
@@ -448,6 +774,13 @@ def run_interpreter(
     if state_t is not None:
         state_addr = state_t.buffer_address()
         defines.append(("STATE_DRAM_ADDR", hex(state_addr)))
+        if ring_t is not None:
+            defines.append(("RING_DRAM_ADDR", hex(ring_t.buffer_address())))
+        if sessions > 1:
+            defines.append(("ZORK_SESSIONS", str(sessions)))
+    # Superinstruction fusion stays opt-in until it has run on hardware.
+    if os.environ.get("ZORK_FUSE", "") == "1":
+        defines.append(("ZORK_FUSE", "1"))
 
     # Build KernelDescriptor for the RISC-V data-movement kernel.
     #
@@ -496,6 +829,8 @@ def run_interpreter(
     # tensor ordering in this list does NOT affect kernel behavior.
     if state_t is not None:
         all_tensors = [game_t, input_t, state_t, output_t]  # output_t last = "the output"
+        if ring_t is not None:
+            all_tensors.insert(3, ring_t)
     else:
         all_tensors = [game_t, input_t, output_t]
 
@@ -520,11 +855,11 @@ def run_zork(
     ttnn.generic_op() within a single ttnn.open_device() session always hangs,
     regardless of instruction count or state content.
 
-    This function works around both limits by opening and closing the ttnn device
-    for EACH batch. The Z-machine state (PC, stack, call frames, dynamic game memory)
-    is serialised to host-side bytes between sessions via download_state() / upload_state().
-    Each batch is therefore the first (and only) kernel invocation in its device session
-    — confirmed reliable even when PRINT fires.
+    This function works around both limits by running ten-instruction batches and
+    reopening the ttnn device after every LAUNCHES_PER_OPEN of them (DeviceSession).
+    The Z-machine state (PC, stack, call frames, dynamic game memory) stays on the
+    device between the launches of one device session and crosses to the host
+    when the device is reopened.
 
     10 batches × 10 instructions = 100 total instructions produces the full Zork
     opening sequence including "West of House" and the first room description.
@@ -539,6 +874,47 @@ def run_zork(
     Returns:
         Accumulated game output text across all batches (non-empty batches only).
     """
+    text, _ = run_session(game_path, command=command, verbose=verbose, num_batches=num_batches)
+    return text
+
+
+def run_session(
+    game_path: str | Path,
+    state: bytes | None = None,
+    command: str = "",
+    verbose: bool = False,
+    num_batches: int | None = None,
+    undo: int = 0,
+    save_slot: int | None = None,
+    headless: bool = False,
+) -> tuple[str, bytes | None]:
+    """
+    Run batches from a saved state and return the output plus the new state.
+
+    Same batch loop as run_zork(), but the caller owns the state bytes, so a
+    session can be continued turn by turn.
+
+    Args:
+        game_path:   Path to the story file.
+        state:       Bytes from a previous run_session(), or None for a fresh game.
+        command:     Input command for the READ this run reaches.
+        verbose:     Print progress messages to stdout.
+        num_batches: Number of 10-instruction batches (default: DEFAULT_BATCHES / ZORK_BATCHES).
+        undo:        If > 0, the first batch carries HOST_CMD_UNDO with this many
+                     levels: the kernel restores the snapshot taken at that READ and
+                     returns without interpreting. Later batches re-run the READ
+                     with `command`. Check undo_depth(state) first.
+        save_slot:   If set (0..SAVE_SLOTS-1), select the slot the game's SAVE and
+                     RESTORE opcodes use from here on (HOST_CMD_SLOT, sent with
+                     the first batch that runs). The selection persists in state.
+        headless:    Run with HOST_FLAG_HEADLESS: print opcodes write event
+                     records (zork_state.print_events) instead of decoding text.
+                     The state is the same as with text.
+
+    Returns:
+        (output text of non-empty batches, state bytes after the last batch).
+    """
+
     game_path = Path(game_path)
     if not game_path.exists():
         raise FileNotFoundError(f"Game file not found: {game_path}")
@@ -553,67 +929,116 @@ def run_zork(
         print(f"[zork_risc] Kernel:   {KERNEL_PATH}")
         print(f"[zork_risc] Command:  {command!r}")
         print(f"[zork_risc] Batches:  {num_batches} × 10 instructions = {num_batches*10} total")
-        print(f"[zork_risc] Strategy: per-batch device sessions (workaround for 3rd-invocation hang)")
+        limit = _launches_per_open()
+        print(f"[zork_risc] Strategy: "
+              f"{f'{limit} launches per device session (workaround for 3rd-invocation hang)' if limit else 'one device session'}")
         print()
 
-    # saved_state: host-side bytes of ZMachineState from previous batch.
-    # None on first batch → kernel does fresh init (instruction_count == 0).
-    saved_state: bytes | None = None
+    # state None → the kernel does a fresh init (instruction_count == 0).
     all_text: list[str] = []
     seen_output = False  # True once we have seen at least one non-empty batch
 
-    for batch in range(num_batches):
-        if verbose:
-            print(f"[zork_risc] Batch {batch + 1}/{num_batches}: opening device...", flush=True)
+    with DeviceSession(game_path, 1, [state]) as session:
+        for batch in range(num_batches):
+            if verbose:
+                print(f"[zork_risc] Batch {batch + 1}/{num_batches}: launching...", flush=True)
 
-        device = ttnn.open_device(device_id=0)
-        try:
-            game_t   = load_game(game_path, device)
-            output_t = make_output(device)
-            input_t  = make_input(device, command)
+            bufs = session.buffers()
+            host_cmd = None
+            if undo and batch == 0:
+                host_cmd = (HOST_CMD_UNDO, undo)
+            elif save_slot is not None and batch == (1 if undo else 0):
+                host_cmd = (HOST_CMD_SLOT, save_slot)
+            bufs.write_inputs([input_block(command, host_cmd, headless)])
 
-            # First batch: fresh zeroed state (instruction_count == 0 → fresh init).
-            # Subsequent batches: restore state from previous batch via upload_state().
-            if saved_state is None:
-                state_t = make_state(device)
-            else:
-                state_t = upload_state(device, saved_state)
+            if verbose:
+                print(f"  game:   {bufs.game_t.buffer_address():#010x}")
+                print(f"  output: {bufs.output_t.buffer_address():#010x}")
+                print(f"  input:  {bufs.input_t.buffer_address():#010x}")
+                print(f"  state:  {bufs.state_t.buffer_address():#010x}  "
+                      f"(device session {session.opens})")
+
+            bufs.launch()
+            batch_text = bufs.read_outputs()[0]
+            all_text.append(batch_text)
+
+            if batch_text.strip():
+                seen_output = True
+
+            # An UNDO batch only restores state; it never produces output.
+            if undo and batch == 0:
+                continue
 
             if verbose:
-                print(f"  game:   {game_t.buffer_address():#010x}")
-                print(f"  output: {output_t.buffer_address():#010x}")
-                print(f"  input:  {input_t.buffer_address():#010x}")
-                print(f"  state:  {state_t.buffer_address():#010x}  ({'fresh' if saved_state is None else 'restored'})")
+                n_chars = len(batch_text.strip())
+                print(f"  → {n_chars} chars of output", flush=True)
+                if batch_text.strip():
+                    preview = batch_text.strip()[:200]
+                    print(f"  → preview: {preview!r}", flush=True)
 
-            run_interpreter(game_t, output_t, input_t, device, state_t=state_t)
+            # Only stop early once we HAVE seen game output and it then stops.
+            # Do NOT stop in the silent warm-up batches before the first PRINT fires,
+            # nor after a ring launch, which prints nothing by design.
+            if seen_output and not batch_text.strip() and not ring_launched(bufs.read_states()[0]):
+                if verbose:
+                    print("  → no output after previous content — game finished or stalled")
+                break
+
+        saved_state = session.states()[0]
+
+    return "\n".join(t for t in all_text if t.strip()), saved_state
 
-            batch_text = read_output(output_t)
-            all_text.append(batch_text)
 
-            # Save state to host before closing device
-            saved_state = download_state(state_t)
+def run_sessions(
+    game_path: str | Path,
+    commands: list[str],
+    states: list[bytes | None] | None = None,
+    num_batches: int | None = None,
+    headless: bool = False,
+) -> tuple[list[str], list[bytes]]:
+    """
+    Advance several independent games together, time-sliced on one core.
 
-        finally:
-            ttnn.close_device(device)
+    Each launch runs one 10-instruction slice of every session (kernel
+    ZORK_SESSIONS) over one DeviceBuffers, so N games share the device sessions
+    one game would need. Sessions never stop early: the batch count is fixed.
 
-        if batch_text.strip():
-            seen_output = True
+    Args:
+        game_path:   Path to the story file (shared by all sessions).
+        commands:    One input command per session, 1..DEVICE_SESSIONS of them.
+        states:      Per-session bytes from a previous run_sessions() or
+                     run_session(); None entries (or no list) start fresh games.
+        num_batches: Number of batches (default: DEFAULT_BATCHES / ZORK_BATCHES).
+        headless:    Run every session with HOST_FLAG_HEADLESS (see run_session()).
 
-        if verbose:
-            n_chars = len(batch_text.strip())
-            print(f"  → {n_chars} chars of output", flush=True)
-            if batch_text.strip():
-                preview = batch_text.strip()[:200]
-                print(f"  → preview: {preview!r}", flush=True)
+    Returns:
+        (output text per session, state bytes per session).
+    """
+    game_path = Path(game_path)
+    if not game_path.exists():
+        raise FileNotFoundError(f"Game file not found: {game_path}")
+    n = len(commands)
+    if not 1 <= n <= DEVICE_SESSIONS:
+        raise ValueError(f"run_sessions: need 1..{DEVICE_SESSIONS} sessions, got {n} "
+                         f"(ZORK_DEVICE_SESSIONS raises the limit, up to {MAX_SESSIONS})")
+    if num_batches is None:
+        env_batches = os.environ.get("ZORK_BATCHES", "")
+        num_batches = int(env_batches) if env_batches.isdigit() else DEFAULT_BATCHES
 
-        # Only stop early once we HAVE seen game output and it then stops.
-        # Do NOT stop in the silent warm-up batches before the first PRINT fires.
-        if seen_output and not batch_text.strip():
-            if verbose:
-                print("  → no output after previous content — game finished or stalled")
-            break
+    inputs = [input_block(command, None, headless) for command in commands]
+
+    texts: list[list[str]] = [[] for _ in range(n)]
+    with DeviceSession(game_path, n, list(states or [])) as session:
+        for _ in range(num_batches):
+            bufs = session.buffers()
+            bufs.write_inputs(inputs)
+            bufs.launch()
+            for i, text in enumerate(bufs.read_outputs()):
+                if text.strip():
+                    texts[i].append(text)
+        current = session.states()
 
-    return "\n".join(t for t in all_text if t.strip())
+    return ["\n".join(t) for t in texts], current
 
 
 # ---------------------------------------------------------------------------
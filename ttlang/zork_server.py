@@ -0,0 +1,269 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_server.py — Long-running session server over a Unix-domain socket.
+
+play.py runs one game per process, and every RiscVEngine call opens the device
+again. ZorkServer is one process that owns the backend and serves many client
+sessions at once. Each client sends one JSON object per line and gets one JSON
+object back per line:
+
+    {"op": "create"}                         -> {"ok": true, "session": 3, "text": <opening>}
+    {"op": "step", "session": 3, "command": "open mailbox"}
+                                             -> {"ok": true, "text": "...", "batch": 2}
+        ("batch": how many steps shared the backend call that ran this one)
+    {"op": "snapshot", "session": 3}         -> {"ok": true, "image": <base64>}
+    {"op": "restore", "image": <base64>}     -> {"ok": true, "session": 4}
+        (with "session": n it replaces open session n's state instead)
+    {"op": "close", "session": 3}            -> {"ok": true}
+    {"op": "metrics"}                        -> {"ok": true, "queue_depth": ..., ...}
+
+Any failure answers {"ok": false, "error": "..."}.
+
+Steps from all clients go through one SessionLoop (ttlang/zork_async.py). It
+takes as many pending steps as the backend's width allows, one per session, and
+runs them in a single backend call. On the device that is one run_sessions()
+launch sequence for up to DEVICE_SESSIONS games. Metrics report the queue depth,
+the launch count, the mean batch size and step latency percentiles.
+
+Backends (--backend):
+    device — the RISC-V kernel via zork_risc.run_sessions(); snapshots are
+             portable session images (zork_image).
+    host   — the same kernel built for the host CPU, via zork_native.run_sessions(),
+             for machines without a card; same batches and snapshots as device.
+    python — the Python interpreter (ZMachineV3), run to each READ; snapshots
+             are JSON of its VM state.
+
+Usage:
+    python ttlang/zork_server.py game/zork1.z3 --backend host --socket /tmp/zork.sock
+"""
+from __future__ import annotations
+
+import argparse
+import asyncio
+import base64
+import json
+import socket
+import sys
+from pathlib import Path
+from typing import Any
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from ttlang.zmachine_v3 import ZMachineV3
+from ttlang.zork_async import SessionLoop
+
+DEFAULT_SOCKET = "/tmp/zork.sock"
+
+# Instructions per interpret() call while the host backend runs to the next READ.
+_HOST_SLICE = 2000
+
+
+class HostBackend:
+    """ZMachineV3 sessions on the host CPU (--backend python); every pending step fits one batch."""
+
+    width = 1 << 30
+
+    def __init__(self, game_path: str | Path) -> None:
+        self.story = Path(game_path).read_bytes()
+
+    def new_state(self) -> ZMachineV3:
+        return ZMachineV3(self.story)
+
+    def run_many(self, states: list[ZMachineV3], commands: list[str]) -> tuple[list[str], list[ZMachineV3]]:
+        texts = []
+        for zm, command in zip(states, commands):
+            zm.input_command = command
+            zm.interpret(_HOST_SLICE)
+            while zm.running and not zm.waiting_for_input:
+                zm.interpret(_HOST_SLICE)
+            texts.append(zm.flush_output())
+        return texts, states
+
+    def snapshot(self, zm: ZMachineV3) -> bytes:
+        state = zm.save_state()
+        state["memory"] = base64.b64encode(state["memory"]).decode("ascii")
+        return json.dumps(state).encode("ascii")
+
+    def restore(self, data: bytes) -> ZMachineV3:
+        state = json.loads(data)
+        state["memory"] = base64.b64decode(state["memory"])
+        return ZMachineV3.from_state(self.story, state)
+
+
+class DeviceBackend:
+    """The RISC-V kernel; a batch is one run_sessions() call of up to DEVICE_SESSIONS games."""
+
+    def __init__(self, game_path: str | Path, num_batches: int = 6) -> None:
+        from ttlang import zork_risc  # needs ttnn: import only when used
+        self._risc = zork_risc
+        self.game_path = Path(game_path)
+        self.story = self.game_path.read_bytes()
+        self.num_batches = num_batches
+        self.width = zork_risc.DEVICE_SESSIONS
+
+    def new_state(self) -> bytes | None:
+        return None
+
+    def run_many(self, states: list[bytes | None], commands: list[str]) -> tuple[list[str], list[bytes]]:
+        return self._risc.run_sessions(self.game_path, commands, states=states,
+                                       num_batches=self.num_batches)
+
+    def snapshot(self, state: bytes | None) -> bytes:
+        from ttlang.zork_image import export_image
+        return export_image(state or bytes(self._risc.STATE_SIZE), self.story)
+
+    def restore(self, data: bytes) -> bytes:
+        from ttlang.zork_image import import_image
+        return import_image(data, self.story).state
+
+
+class NativeBackend(DeviceBackend):
+    """DeviceBackend over the kernel built for the host (zork_native); no card needed."""
+
+    def __init__(self, game_path: str | Path, num_batches: int = 6) -> None:
+        from ttlang import zork_native
+        from ttlang.zork_state import MAX_SESSIONS
+        self._risc = zork_native
+        self.game_path = Path(game_path)
+        self.story = self.game_path.read_bytes()
+        self.num_batches = num_batches
+        self.width = MAX_SESSIONS
+
+
+BACKENDS = {"device": DeviceBackend, "host": NativeBackend, "python": HostBackend}
+
+
+def make_backend(name: str, game_path: str | Path, batches: int = 6) -> Any:
+    """The --backend `name` for game_path; batches is per step on the kernel backends."""
+    if name == "python":
+        return HostBackend(game_path)
+    return BACKENDS[name](game_path, batches)
+
+
+class ZorkServer:
+    """Serve SessionLoop sessions to socket clients."""
+
+    def __init__(self, backend: Any, socket_path: str = DEFAULT_SOCKET) -> None:
+        self.backend = backend
+        self.socket_path = socket_path
+        self.loop = SessionLoop(backend)
+
+    @property
+    def sessions(self) -> dict[int, Any]:
+        return self.loop.states
+
+    def metrics(self) -> dict:
+        return self.loop.metrics()
+
+    async def handle(self, request: dict) -> dict:
+        op = request.get("op")
+        if op == "create":
+            session = await self.loop.open()
+            return {"session": session.id, "text": session.opening}
+        if op == "step":
+            text, batch = await self.loop.step_batch(int(request["session"]),
+                                                     str(request.get("command", "")))
+            return {"text": text, "batch": batch}
+        if op == "snapshot":
+            image = await self.loop.snapshot(int(request["session"]))
+            return {"image": base64.b64encode(image).decode("ascii")}
+        if op == "restore":
+            state = self.backend.restore(base64.b64decode(request["image"]))
+            if "session" in request:
+                return {"session": (await self.loop.replace(int(request["session"]), state)).id}
+            return {"session": self.loop.attach(state).id}
+        if op == "close":
+            self.loop.close_session(int(request["session"]))
+            return {}
+        if op == "metrics":
+            return self.metrics()
+        raise ValueError(f"unknown op {op!r}")
+
+    async def _client(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter) -> None:
+        try:
+            while line := await reader.readline():
+                try:
+                    reply = {"ok": True, **await self.handle(json.loads(line))}
+                except Exception as exc:
+                    reply = {"ok": False, "error": f"{type(exc).__name__}: {exc}"}
+                writer.write(json.dumps(reply).encode() + b"\n")
+                await writer.drain()
+        finally:
+            writer.close()
+
+    async def serve(self, ready: asyncio.Event | None = None) -> None:
+        """Serve until cancelled."""
+        Path(self.socket_path).unlink(missing_ok=True)
+        server = await asyncio.start_unix_server(self._client, path=self.socket_path,
+                                                 limit=1 << 24)
+        self.loop.start()
+        if ready is not None:
+            ready.set()
+        try:
+            async with server:
+                await server.serve_forever()
+        finally:
+            await self.loop.stop()
+            Path(self.socket_path).unlink(missing_ok=True)
+
+
+class ZorkClient:
+    """Blocking client for ZorkServer; one connection, one request at a time."""
+
+    def __init__(self, socket_path: str = DEFAULT_SOCKET) -> None:
+        self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self._sock.connect(socket_path)
+        self._file = self._sock.makefile("rwb")
+
+    def request(self, **request: Any) -> dict:
+        self._file.write(json.dumps(request).encode() + b"\n")
+        self._file.flush()
+        reply = json.loads(self._file.readline())
+        if not reply.pop("ok"):
+            raise RuntimeError(reply["error"])
+        return reply
+
+    def create(self) -> tuple[int, str]:
+        reply = self.request(op="create")
+        return reply["session"], reply["text"]
+
+    def step(self, session: int, command: str) -> str:
+        return self.request(op="step", session=session, command=command)["text"]
+
+    def snapshot(self, session: int) -> str:
+        return self.request(op="snapshot", session=session)["image"]
+
+    def restore(self, image: str, session: int | None = None) -> int:
+        extra = {} if session is None else {"session": session}
+        return self.request(op="restore", image=image, **extra)["session"]
+
+    def close_session(self, session: int) -> None:
+        self.request(op="close", session=session)
+
+    def metrics(self) -> dict:
+        return self.request(op="metrics")
+
+    def close(self) -> None:
+        self._file.close()
+        self._sock.close()
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("game", type=Path, help="Z-machine story file")
+    parser.add_argument("--socket", default=DEFAULT_SOCKET)
+    parser.add_argument("--backend", choices=tuple(BACKENDS), default="device")
+    parser.add_argument("--batches", type=int, default=6, help="kernel batches per step")
+    args = parser.parse_args()
+
+    backend = make_backend(args.backend, args.game, args.batches)
+    print(f"[zork_server] {args.backend} backend on {args.socket}", flush=True)
+    try:
+        asyncio.run(ZorkServer(backend, args.socket).serve())
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
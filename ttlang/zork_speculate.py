@@ -0,0 +1,259 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_speculate.py — Speculative pre-execution of likely next commands.
+
+A turn on the RISC-V kernel is several device launches long (STEP_BATCHES × one
+open/run/close each). While the player is still reading a response,
+SpeculativeSession runs the commands they are most likely to type next from the
+current state and caches each (text, state) result. If the real command matches
+a cached one, the result is served without touching the device and the cached
+state becomes the session state. The latency hides behind the player's think time.
+
+Candidates run DEVICE_SESSIONS at a time through the kernel's time-sliced sessions
+(zork_risc.run_sessions). The host drives a single core (0,0) today, so
+"idle cores" here means idle session slots on that core. Speculation runs one
+batch (one launch) per runner call and checks for a real command after each,
+so a miss waits for at most one launch, not a whole speculated command.
+
+Real commands and speculated ones run through the same runner, run_sessions()
+(a miss is a one-session call of num_batches). run_session() stops early once
+the output goes quiet, run_sessions() always runs every batch, and the two
+reach different states, so a cache hit must come from the same stopping rule
+as a miss. num_batches one-batch calls reach the state one num_batches call
+does, and their texts join the same way (_join_batches). The
+kernel is deterministic (RANDOM returns 1 and there is no clock), so a cached
+result is then byte-for-byte what the miss would have produced from the same
+state, command and batch count. Cache keys are (hash of state bytes, normalised
+command), so UNDO back to an earlier state can still hit.
+
+predict_commands() ranks candidates like this:
+    1. direction words the last response mentions (the room's exits),
+    2. a fixed list of common commands,
+    3. the remaining directions,
+filtered through the story's vocabulary (tui/vocabulary.py) when one is given.
+
+engines/riscv.py (RiscVEngine) plays its turns through a SpeculativeSession.
+
+Usage:
+    spec = SpeculativeSession("game/zork1.z3")
+    print(spec.start())
+    while True:
+        print(spec.step(input("> ")))     # starts speculating on return
+"""
+from __future__ import annotations
+
+import hashlib
+import re
+import threading
+from collections import OrderedDict
+from pathlib import Path
+from typing import Callable
+
+# Directions in the order the parser lists them; abbreviations are not worth a slot.
+DIRECTIONS: tuple[str, ...] = (
+    "north", "south", "east", "west", "northeast", "northwest",
+    "southeast", "southwest", "up", "down", "in", "out",
+)
+
+# Commands players type most often regardless of the room.
+COMMON_COMMANDS: tuple[str, ...] = (
+    "look", "inventory", "take all", "open door", "wait", "score",
+)
+
+# Default number of speculated commands per turn.
+DEFAULT_TOP_K = 8
+
+# Cached results kept across turns (least recently used dropped first).
+CACHE_ENTRIES = 64
+
+_WORD = re.compile(r"[a-z]+")
+
+# (states, commands, num_batches) -> (texts, states), zork_risc.run_sessions()'s shape
+RunMany = Callable[[list[bytes | None], list[str], int], tuple[list[str], list[bytes]]]
+
+
+def normalize_command(command: str) -> str:
+    """Lowercase and collapse whitespace — the form the cache is keyed on."""
+    return " ".join(command.lower().split())
+
+
+def predict_commands(
+    last_text: str,
+    vocabulary: frozenset[str] = frozenset(),
+    k: int = DEFAULT_TOP_K,
+) -> list[str]:
+    """
+    Rank the k commands the player is most likely to type after last_text.
+
+    Args:
+        last_text:  Game output of the previous turn.
+        vocabulary: Story words from tui.vocabulary.extract_vocabulary(); V3
+                    dictionary words are truncated to 6 characters, so a command's
+                    verb matches on its first 6 letters. Empty = no filtering.
+        k:          Number of commands to return.
+    """
+    words = _WORD.findall(last_text.lower())
+    mentioned = [w for w in words if w in DIRECTIONS]
+    ranked: list[str] = []
+    for command in [*mentioned, *COMMON_COMMANDS, *DIRECTIONS]:
+        if len(ranked) >= k:
+            break
+        if command in ranked:
+            continue
+        verb = command.split()[0]
+        if vocabulary and verb not in vocabulary and verb[:6] not in vocabulary:
+            continue
+        ranked.append(command)
+    return ranked
+
+
+def _state_key(state: bytes | None) -> bytes:
+    return hashlib.blake2b(state or b"", digest_size=16).digest()
+
+
+def _join_batches(texts: list[str]) -> str:
+    """Texts of one-batch runs, joined the way run_sessions() joins its batches."""
+    return "\n".join(t for t in texts if t.strip())
+
+
+class SpeculativeSession:
+    """
+    One game session on the RISC-V kernel with speculative pre-execution.
+
+    Not thread-safe for callers: drive start()/step() from one thread. The
+    speculation worker is internal and never touches the device while step()
+    is running.
+    """
+
+    def __init__(
+        self,
+        game_path: str | Path,
+        num_batches: int = 6,
+        top_k: int = DEFAULT_TOP_K,
+        vocabulary: frozenset[str] | None = None,
+        run_many: RunMany | None = None,
+        width: int | None = None,
+    ) -> None:
+        """
+        Args:
+            game_path:   Story file.
+            num_batches: Batches per turn, real and speculated (engines.riscv.STEP_BATCHES).
+            top_k:       Commands speculated per turn.
+            vocabulary:  Story vocabulary; None = extract it from game_path.
+            run_many:    (states, commands, num_batches) -> (texts, states) for real
+                         and speculated commands alike. Default: zork_risc.run_sessions.
+            width:       Commands per run_many call. Default: zork_risc.DEVICE_SESSIONS.
+        """
+        self.game_path = Path(game_path)
+        self.num_batches = num_batches
+        self.top_k = top_k
+        if vocabulary is None:
+            vocabulary = _story_vocabulary(self.game_path)
+        self.vocabulary = vocabulary
+        if run_many is None or width is None:
+            from ttlang import zork_risc  # needs ttnn: import only when used
+            if run_many is None:
+                run_many = lambda states, commands, num_batches: zork_risc.run_sessions(
+                    self.game_path, commands, states=states, num_batches=num_batches)
+            if width is None:
+                width = zork_risc.DEVICE_SESSIONS
+        self._run_many = run_many
+        self._width = width
+
+        self.state: bytes | None = None
+        self.hits = 0
+        self.misses = 0
+        self._cache: OrderedDict[tuple[bytes, str], tuple[str, bytes]] = OrderedDict()
+        self._worker: threading.Thread | None = None
+        self._stop = threading.Event()
+
+    def start(self, num_batches: int | None = None) -> str:
+        """
+        Run the opening from a fresh game and begin speculating.
+
+        num_batches overrides the per-turn count for the opening only
+        (engines.riscv.STARTUP_BATCHES); the result is then not cached.
+        """
+        if num_batches is None or num_batches == self.num_batches:
+            return self.step("")
+        self.cancel()
+        self.misses += 1
+        (text,), (self.state,) = self._run_many([None], [""], num_batches)
+        self.speculate(text)
+        return text
+
+    def step(self, command: str) -> str:
+        """Play command, from the cache when it was speculated, and return its text."""
+        self.cancel()
+        key = (_state_key(self.state), normalize_command(command))
+        cached = self._cache.get(key)
+        if cached is not None:
+            self._cache.move_to_end(key)
+            self.hits += 1
+            text, self.state = cached
+        else:
+            self.misses += 1
+            (text,), (self.state,) = self._run_many([self.state], [command], self.num_batches)
+            self._remember(key, text, self.state)
+        self.speculate(text)
+        return text
+
+    def speculate(self, last_text: str) -> None:
+        """Start pre-executing predicted commands from the current state."""
+        self.cancel()
+        state = self.state
+        key = _state_key(state)
+        commands = [
+            c for c in predict_commands(last_text, self.vocabulary, self.top_k)
+            if (key, c) not in self._cache
+        ]
+        if not commands:
+            return
+        self._stop.clear()
+        self._worker = threading.Thread(
+            target=self._speculate, args=(state, key, commands), daemon=True)
+        self._worker.start()
+
+    def wait(self) -> None:
+        """Block until every predicted command of this turn is cached."""
+        if self._worker is not None:
+            self._worker.join()
+            self._worker = None
+
+    def cancel(self) -> None:
+        """Stop speculating; returns once the one launch in flight has finished."""
+        if self._worker is not None:
+            self._stop.set()
+            self._worker.join()
+            self._worker = None
+
+    def _speculate(self, state: bytes | None, key: bytes, commands: list[str]) -> None:
+        for i in range(0, len(commands), self._width):
+            group = commands[i:i + self._width]
+            states: list[bytes | None] = [state] * len(group)
+            texts: list[list[str]] = [[] for _ in group]
+            for _ in range(self.num_batches):
+                if self._stop.is_set():
+                    return   # a real command is waiting; drop the partial group
+                outs, states = self._run_many(states, group, 1)
+                for parts, text in zip(texts, outs):
+                    parts.append(text)
+            for command, parts, new_state in zip(group, texts, states):
+                self._remember((key, command), _join_batches(parts), new_state)
+
+    def _remember(self, key: tuple[bytes, str], text: str, state: bytes) -> None:
+        self._cache[key] = (text, state)
+        self._cache.move_to_end(key)
+        while len(self._cache) > CACHE_ENTRIES:
+            self._cache.popitem(last=False)
+
+
+def _story_vocabulary(game_path: Path) -> frozenset[str]:
+    """Vocabulary of the story via the reference interpreter; empty if unreadable."""
+    try:
+        from ttlang.zmachine_v3 import ZMachineV3
+        from tui.vocabulary import extract_vocabulary
+        return extract_vocabulary(ZMachineV3(game_path.read_bytes()))
+    except Exception:
+        return frozenset()
@@ -0,0 +1,196 @@
+# SPDX-FileCopyrightText: © 2026 Tenstorrent Inc.
+# SPDX-License-Identifier: Apache-2.0
+"""
+zork_state.py — Read the RISC-V kernel's state bytes on the host.
+
+run_session() / run_sessions() hand back one STATE_SIZE block per session. This
+module knows its layout, so host tools can look inside without ttnn: the explorer
+dedups states by hash and names the room each one is in. print_events() reads
+the output of a headless run (HOST_FLAG_HEADLESS) the same way. input_block()
+builds the other side: the per-session input block every launcher hands the kernel.
+
+Layout (ZMachineState as laid out by the 32-bit RISC-V compiler, then dynamic memory):
+    0      pc_offset          u32   PC as an offset into story memory
+    4      sp                 u32
+    8      stack[1024]        u16 × 1024 (little-endian)
+    2056   frame_sp           u32
+    2060   frames[64]         40 B each: ret_pc u32 @0, num_locals u8 @4,
+                              locals[15] u16 @6, store_var u8 @36 (rest padding)
+    4620   finished           u8
+    4624   out_pos, instruction_count, undo_head, undo_count, save_slot,
+           save_dir[4], verify_*, ring_stage (host bookkeeping — not part of
+           the game state)
+    4704   dynamic memory     story bytes 0 .. header[0x0E]
+    32 KB  UNDO ring (8 × 4 KB), then SAVE slots (4 × 8 KB), to 96 KB
+"""
+from __future__ import annotations
+
+import hashlib
+import re
+
+STATE_PC_OFFSET = 0
+STATE_SP_OFFSET = 4
+STATE_STACK_OFFSET = 8
+STATE_FRAME_SP_OFFSET = 2056
+STATE_FRAMES_OFFSET = 2060
+STATE_FINISHED_OFFSET = 4620
+STATE_OUT_POS_OFFSET = 4624
+STATE_INSTRUCTION_COUNT_OFFSET = 4628
+STATE_UNDO_HEAD_OFFSET = 4632
+STATE_UNDO_COUNT_OFFSET = 4636
+STATE_SAVE_SLOT_OFFSET = 4640
+STATE_SAVE_DIR_OFFSET = 4644     # SaveSlot[4]: size u32, release u16, checksum u16
+STATE_VERIFY_OFFSET = 4676       # verify_key, verify_result, verify_pos, verify_sum
+STATE_RING_STAGE_OFFSET = 4692
+# sizeof(ZMachineState): the last field ends here. A new kernel field goes before
+# it, and every serialiser of the fields (zork_image) copies up to it.
+STATE_STRUCT_SIZE = 4696
+STATE_DYN_OFFSET = 4704  # STATE_STRUCT_SIZE rounded up to 32
+STATE_RING_OFFSET = 32 * 1024    # UNDO ring, then SAVE slots, to STATE_SIZE
+STATE_SIZE = 96 * 1024
+
+# Time-sliced sessions the kernel layout holds per launch (ZORK_SESSIONS <= this);
+# session i owns bytes [i*STATE_SIZE, (i+1)*STATE_SIZE) of the state tensor.
+MAX_SESSIONS = 4
+
+FRAME_SIZE = 40
+
+# Input block: one per session, INPUT_SIZE bytes. The command is null-terminated
+# ASCII from byte 0. The last 16 bytes are the host command block: little-endian
+# u32 words (op, arg, flags), zero = no command. Must match HOST_CMD_* and
+# HOST_FLAG_* in the kernel.
+INPUT_SIZE = 1024
+HOST_CMD_OFFSET = 1008
+HOST_CMD_UNDO = 1        # arg = number of turns to roll back
+HOST_CMD_SLOT = 2        # arg = save slot used by the game's SAVE/RESTORE
+HOST_FLAG_HEADLESS = 1   # print event records instead of text (print_events)
+
+# ZMachineState.ring_stage (kernel RingStage): READ's UNDO snapshot, SAVE and
+# RESTORE run in a launch of their own, after the slice that stopped at them
+RING_DUE = 1
+RING_TAKEN = 2
+RING_RAN = 3
+_FRAME_FIELDS = ((0, 5), (6, 37))  # ret_pc + num_locals, locals + store_var
+
+
+def _u32(state: bytes, off: int) -> int:
+    return int.from_bytes(state[off:off + 4], "little")
+
+
+def dynamic_size(story: bytes) -> int:
+    """Size of the story's dynamic memory (static memory base, header 0x0E)."""
+    return int.from_bytes(story[0x0E:0x10], "big")
+
+
+def is_fresh(state: bytes | None) -> bool:
+    """True when the kernel would start this state from the story's initial PC."""
+    return not state or _u32(state, STATE_INSTRUCTION_COUNT_OFFSET) == 0
+
+
+def is_finished(state: bytes) -> bool:
+    """True once the game has executed QUIT (or the kernel gave up)."""
+    return state[STATE_FINISHED_OFFSET] != 0
+
+
+def ring_due(state: bytes | None) -> bool:
+    """True when the next launch is a ring launch (it reads or writes the UNDO ring or SAVE slots)."""
+    return bool(state) and _u32(state, STATE_RING_STAGE_OFFSET) == RING_DUE
+
+
+def ring_launched(state: bytes | None) -> bool:
+    """True when the launch that left this state was a ring launch (it prints nothing)."""
+    return bool(state) and _u32(state, STATE_RING_STAGE_OFFSET) in (RING_TAKEN, RING_RAN)
+
+
+def waiting_for_input(state: bytes | None) -> bool:
+    """True when the next launch runs a READ (its UNDO snapshot just taken): it reads the input block."""
+    return bool(state) and _u32(state, STATE_RING_STAGE_OFFSET) == RING_TAKEN
+
+
+def input_block(command: str, host_cmd: tuple[int, int] | None = None, headless: bool = False) -> bytes:
+    """One INPUT_SIZE block: null-terminated command plus the host command block."""
+    buf = bytearray(INPUT_SIZE)
+    if command:
+        data = command.encode("ascii", errors="replace")[:HOST_CMD_OFFSET - 1]
+        buf[:len(data)] = data
+    if host_cmd is not None:
+        op, arg = host_cmd
+        buf[HOST_CMD_OFFSET:HOST_CMD_OFFSET + 8] = op.to_bytes(4, "little") + arg.to_bytes(4, "little")
+    if headless:
+        buf[HOST_CMD_OFFSET + 8:HOST_CMD_OFFSET + 12] = HOST_FLAG_HEADLESS.to_bytes(4, "little")
+    return bytes(buf)
+
+
+def dynamic_memory(state: bytes, story: bytes) -> bytes:
+    """The session's dynamic memory (globals, object tree, flags)."""
+    return state[STATE_DYN_OFFSET:STATE_DYN_OFFSET + dynamic_size(story)]
+
+
+def vm_bytes(state: bytes) -> bytes:
+    """
+    Canonical VM context: PC, the live stack and the live call frames.
+
+    Stack slots above sp and frame padding hold leftovers from earlier turns, so
+    they are left out; two states that differ only there are the same state.
+    """
+    sp = _u32(state, STATE_SP_OFFSET)
+    frame_sp = _u32(state, STATE_FRAME_SP_OFFSET)
+    parts = [
+        state[STATE_PC_OFFSET:STATE_PC_OFFSET + 4],
+        state[STATE_SP_OFFSET:STATE_SP_OFFSET + 4],
+        state[STATE_STACK_OFFSET:STATE_STACK_OFFSET + 2 * sp],
+        state[STATE_FRAME_SP_OFFSET:STATE_FRAME_SP_OFFSET + 4],
+    ]
+    for i in range(frame_sp):
+        base = STATE_FRAMES_OFFSET + i * FRAME_SIZE
+        for lo, hi in _FRAME_FIELDS:
+            parts.append(state[base + lo:base + hi])
+    return b"".join(parts)
+
+
+def state_hash(state: bytes, story: bytes) -> str:
+    """Hash of the game state — VM context plus dynamic memory — as hex."""
+    h = hashlib.blake2b(digest_size=16)
+    h.update(vm_bytes(state))
+    h.update(dynamic_memory(state, story))
+    return h.hexdigest()
+
+
+def global_variable(state: bytes, story: bytes, index: int) -> int:
+    """Global variable index (0-based, i.e. Z-machine variable 0x10 + index)."""
+    addr = int.from_bytes(story[0x0C:0x0E], "big") + 2 * index
+    dyn = dynamic_memory(state, story)
+    return int.from_bytes(dyn[addr:addr + 2], "big")
+
+
+def current_room(state: bytes, story: bytes) -> int:
+    """Object number of the player's location (V3 keeps it in the first global)."""
+    return global_variable(state, story, 0)
+
+
+def object_name(state: bytes, story: bytes, obj: int) -> str:
+    """Short name of object obj as this state's dynamic memory has it."""
+    from ttlang.zmachine_v3 import ZMachineV3
+
+    zm = ZMachineV3(story)
+    dyn = dynamic_memory(state, story)
+    zm.memory[:len(dyn)] = dyn
+    return zm.get_object_name(obj)
+
+
+# Headless output: one record per print, a lowercase kind then 5 uppercase hex digits
+_EVENT = re.compile(r"([a-z])([0-9A-F]{5})")
+EVENT_KINDS = {
+    "s": "print",        # inline string (PRINT / PRINT_RET): byte address
+    "p": "print_paddr",  # byte address (packed address × 2)
+    "a": "print_addr",   # byte address
+    "o": "print_obj",    # object number
+    "n": "print_num",    # value (16-bit, unsigned)
+    "c": "print_char",   # ZSCII code
+    "r": "read",         # text buffer address
+}
+
+
+def print_events(text: str) -> list[tuple[str, int]]:
+    """(kind, operand) records of a headless run's output, in order; kinds as EVENT_KINDS."""
+    return [(kind, int(value, 16)) for kind, value in _EVENT.findall(text)]